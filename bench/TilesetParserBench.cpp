@@ -0,0 +1,157 @@
+/*
+ * Solarus Quest Creator - GUI to build games for Solarus engine
+ * Copyright (C) 2013, Van den Branden Maxime <max.van.den.branden@gmail.com>
+ *
+ * Licensed under the EUPL, Version 1.1
+ * You may not use this work except in compliance with the Licence.
+ * You may obtain a copy of the Licence at:
+ *
+ * http://ec.europa.eu/idabc/eupl
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the Licence is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the Licence for the specific language governing permissions and
+ * limitations under the Licence.
+ */
+/**
+ * @file
+ * @brief Banc d'essai du lecteur natif des Tilesets face au chemin Lua.
+ *
+ * Génère des Tilesets de grande taille, les lit avec TilesetParser puis
+ * avec LuaStatePool, compare les temps et vérifie que les deux chemins
+ * produisent exactement les mêmes patterns.
+ *
+ * Usage : TilesetParserBench [nombre de patterns] [répétitions]
+ */
+#include <cstdio>
+#include <QDir>
+#include <QFile>
+#include <QElapsedTimer>
+#include <QTemporaryDir>
+#include "sol/Tileset.h"
+#include "sol/TilesetParser.h"
+#include "sol/LuaStatePool.h"
+
+static const char *grounds[] = {
+    "traversable", "wall", "empty", "deep_water", "prickles", "lava"
+};
+
+static QByteArray generate (int nbPatterns)
+{
+    QByteArray data = "-- generated tileset\nbackground_color{ 32, 64, 96 }\n";
+    for (int i = 1; i <= nbPatterns; ++i) {
+        int x = (i % 64) * 16, y = (i / 64) * 16;
+        data += "tile_pattern{\n  id = " + QByteArray::number(i) + ",\n";
+        data += "  ground = \"" + QByteArray(grounds[i % 6]) + "\",\n";
+        data += "  default_layer = " + QByteArray::number(i % 3) + ",\n";
+        if (i % 5 == 0) {
+            QByteArray ys = QByteArray::number(y);
+            data += "  x = { " + QByteArray::number(x) + ", " +
+                QByteArray::number(x + 1024) + ", " +
+                QByteArray::number(x + 2048);
+            data += i % 10 == 0 ? ", 0 },\n" : " },\n";
+            data += "  y = { " + ys + ", " + ys + ", " + ys;
+            data += i % 10 == 0 ? ", 0 },\n" : " },\n";
+        } else {
+            data += "  x = " + QByteArray::number(x) + ",\n";
+            data += "  y = " + QByteArray::number(y) + ",\n";
+        }
+        data += "  width = 16,\n  height = 16,\n";
+        if (i % 7 == 0) {
+            data += i % 14 == 0 ?
+                "  scrolling = \"self\",\n" : "  scrolling = \"parallax\",\n";
+        }
+        data += "}\n\n";
+    }
+    return data;
+}
+
+static bool samePattern (const TilePattern &a, const TilePattern &b)
+{
+    return a.id() == b.id() && a.ground() == b.ground() &&
+        a.defaultLayer() == b.defaultLayer() &&
+        a.scrolling() == b.scrolling() && a.width() == b.width() &&
+        a.height() == b.height() && a.x() == b.x() && a.y() == b.y() &&
+        a.isAnimated() == b.isAnimated() &&
+        (!a.isAnimated() || (
+            a.x2() == b.x2() && a.y2() == b.y2() && a.x3() == b.x3() &&
+            a.y3() == b.y3() && a.isSeq0121() == b.isSeq0121()
+        ));
+}
+
+static bool sameTileset (const Tileset &a, const Tileset &b)
+{
+    if (a.backgroundColor() != b.backgroundColor()) {
+        return false;
+    }
+    QList<TilePattern> pa = a.allPatterns(), pb = b.allPatterns();
+    if (pa.size() != pb.size()) {
+        return false;
+    }
+    for (int i = 0; i < pa.size(); ++i) {
+        if (!samePattern(pa[i], pb[i])) {
+            std::printf("pattern %d differs\n", pa[i].id());
+            return false;
+        }
+    }
+    return true;
+}
+
+int main (int argc, char **argv)
+{
+    int nbPatterns = argc > 1 ? QByteArray(argv[1]).toInt() : 20000;
+    int repeat = argc > 2 ? QByteArray(argv[2]).toInt() : 5;
+
+    QTemporaryDir dir;
+    if (!dir.isValid() || !QDir(dir.path()).mkpath("tilesets")) {
+        std::printf("cannot create the working directory\n");
+        return 2;
+    }
+    QString filename = dir.path() + "/tilesets/bench.dat";
+    QFile file(filename);
+    if (!file.open(QIODevice::WriteOnly)) {
+        std::printf("cannot write %s\n", qPrintable(filename));
+        return 2;
+    }
+    file.write(generate(nbPatterns));
+    file.close();
+
+    qint64 nativeTime = 0, luaTime = 0;
+    bool same = true;
+    for (int i = 0; i < repeat && same; ++i) {
+        Tileset native("bench"), lua("bench");
+        QElapsedTimer timer;
+
+        timer.start();
+        if (!TilesetParser::load(&native, filename)) {
+            std::printf("native parser rejected the generated file\n");
+            return 1;
+        }
+        nativeTime += timer.nsecsElapsed();
+
+        timer.start();
+        try {
+            LuaStatePool::Lease lease;
+            lease.setUserData("tileset", &lua);
+            lease.run(filename);
+        } catch (const SQCException &ex) {
+            std::printf("lua: %s\n", qPrintable(ex.message()));
+            return 1;
+        }
+        luaTime += timer.nsecsElapsed();
+
+        same = native.allPatterns().size() == nbPatterns &&
+            sameTileset(native, lua);
+    }
+    if (!same) {
+        std::printf("native and lua paths produced different tilesets\n");
+        return 1;
+    }
+    double native = nativeTime / 1e6 / repeat, lua = luaTime / 1e6 / repeat;
+    std::printf("%d patterns, %d runs\n", nbPatterns, repeat);
+    std::printf("native: %.2f ms\n", native);
+    std::printf("lua:    %.2f ms\n", lua);
+    std::printf("speedup: %.1fx\n", native > 0 ? lua / native : 0.0);
+    return 0;
+}
@@ -18,6 +18,7 @@
 #define ACTION_H
 
 #include <QString>
+#include "MemoryCost.h"
 
 /** Type d'action de base. */
 #define BASIC_ACTION 0
@@ -30,6 +31,11 @@
 class Action
 {
 public:
+    /**
+     * @brief Destructeur d'action.
+     */
+    virtual ~Action ()
+    {}
     /**
      * @brief Exécute l'action.
      */
@@ -65,6 +71,31 @@ public:
     {
         return _message;
     }
+    /**
+     * @brief Estime la mémoire occupée par l'action.
+     *
+     * @return La mémoire estimée, en octets.
+     *
+     * @see estimateMemory
+     */
+    virtual int memoryUsage () const
+    {
+        return sizeof(Action) + estimateMemory(_message);
+    }
+    /**
+     * @brief Fusionne une action suivante dans cette action.
+     *
+     * Appelée par le modèle après l'exécution de `other`. En cas de succès,
+     * cette action représente les deux modifications et `other` est détruite.
+     *
+     * @param other L'action exécutée juste après celle-ci
+     *
+     * @return `true` si les actions ont été fusionnées, `false` sinon.
+     */
+    virtual bool merge (const Action *other)
+    {
+        return false;
+    }
 
 protected:
     /** Le message de l'action detiné aux vues. */
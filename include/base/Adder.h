@@ -65,6 +65,11 @@ public:
         _values = (_model->*_remove)(GroupAction<type_Id>::selection());
     }
 
+    int memoryUsage () const
+    {
+        return GroupAction<type_Id>::memoryUsage() + estimateMemory(_values);
+    }
+
 private:
     type_Model *_model;
     QList<type_SubModel> _values;
@@ -44,6 +44,11 @@ public:
         return _selection;
     }
 
+    int memoryUsage () const
+    {
+        return Action::memoryUsage() + estimateMemory(_selection);
+    }
+
 protected:
     /**
      * @brief Constructeur d'action de groupe.
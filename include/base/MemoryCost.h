@@ -0,0 +1,55 @@
+/*
+ * Solarus Quest Creator - GUI to build games for Solarus engine
+ * Copyright (C) 2013, Van den Branden Maxime <max.van.den.branden@gmail.com>
+ *
+ * Licensed under the EUPL, Version 1.1
+ * You may not use this work except in compliance with the Licence.
+ * You may obtain a copy of the Licence at:
+ *
+ * http://ec.europa.eu/idabc/eupl
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the Licence is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the Licence for the specific language governing permissions and
+ * limitations under the Licence.
+ */
+#ifndef MEMORY_COST_H
+#define MEMORY_COST_H
+
+#include <QString>
+#include <QList>
+
+/**
+ * @brief Estime la mémoire occupée par une valeur.
+ *
+ * Cette fonction est utilisée par les actions pour estimer la taille de
+ * l'historique d'un modèle (Model). Elle peut être surchargée pour les types
+ * qui possèdent des données allouées dynamiquement.
+ *
+ * @param value La valeur
+ *
+ * @return La mémoire estimée, en octets.
+ */
+template<typename type_Value>
+int estimateMemory (const type_Value &)
+{
+    return sizeof(type_Value);
+}
+
+inline int estimateMemory (const QString &value)
+{
+    return sizeof(QString) + value.capacity() * sizeof(QChar);
+}
+
+template<typename type_Value>
+int estimateMemory (const QList<type_Value> &values)
+{
+    int memory = sizeof(QList<type_Value>);
+    for (int i = 0; i < values.size(); i++) {
+        memory += estimateMemory(values.at(i));
+    }
+    return memory;
+}
+
+#endif
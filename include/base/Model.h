@@ -18,7 +18,9 @@
 #define MODEL_H
 
 #include <QList>
+#include <QElapsedTimer>
 #include "Action.h"
+#include "NotifyScheduler.h"
 
 /**
  * @brief Classe abstraite de modèle.
@@ -28,17 +30,21 @@
  * méthode). Elle permet au modèle en manipulant des actions, de fournir une
  * notification spécifique à ses vues.
  *
+ * Les notifications peuvent être différées (setDeferredNotify, beginNotify) :
+ * elles sont alors regroupées et envoyées une seule fois.
+ *
  * @see Action, View
  */
 template<typename type_View>
-class Model
+class Model : public DeferredNotifier
 {
 public:
     /**
      * @brief Destructeur de modèle.
      */
-    ~Model ()
+    virtual ~Model ()
     {
+        delete _scheduler;
         for (int i = 0; i < _actions.size(); i++) {
             delete _actions[i];
         }
@@ -74,7 +80,7 @@ public:
      */
     bool canUndo () const
     {
-        return _currentAction != _actions.begin();
+        return _currentAction > 0;
     }
     /**
      * @brief Vérifie que le modèle peut refaire la dernière action annulée.
@@ -83,7 +89,7 @@ public:
      */
     bool canRedo () const
     {
-        return _currentAction != _actions.end();
+        return _currentAction < _actions.size();
     }
     /**
      * @brief Annule la dernière action effectuée.
@@ -92,8 +98,10 @@ public:
     {
         if (canUndo()) {
             _currentAction--;
-            (*_currentAction)->reverse();
-            _notifyAction(*_currentAction);
+            Action *action = _actions[_currentAction];
+            action->reverse();
+            _mergeable = false;
+            _notifyAction(action);
         }
     }
     /**
@@ -102,9 +110,10 @@ public:
     void redo ()
     {
         if (canRedo()) {
-            Action *action = *_currentAction;
+            Action *action = _actions[_currentAction];
             action->execute();
             _currentAction++;
+            _mergeable = false;
             _notifyAction(action);
         }
     }
@@ -113,11 +122,138 @@ public:
      */
     void clearActions ()
     {
+        bool saved = checkSaveReference();
         for (int i = 0; i < _actions.size(); i++) {
             delete _actions[i];
         }
         _actions.clear();
-        _currentAction = _actions.end();
+        _actionsMemory.clear();
+        _historyMemory = 0;
+        _currentAction = 0;
+        _saveReference = saved ? 0 : -1;
+        _mergeable = false;
+    }
+    /**
+     * @brief Limite la taille de l'historique des actions.
+     *
+     * Lorsque l'une des limites est dépassée, les actions les plus anciennes
+     * sont supprimées. La dernière action effectuée est toujours conservée.
+     *
+     * @param maxActions Le nombre maximum d'actions, 0 pour ne pas limiter
+     * @param maxMemory  La mémoire maximum estimée en octets, 0 pour ne pas
+     *                   limiter
+     *
+     * @see Action::memoryUsage
+     */
+    void setHistoryLimit (int maxActions, int maxMemory = 0)
+    {
+        _maxActions = maxActions;
+        _maxMemory = maxMemory;
+        _trimHistory();
+    }
+    /**
+     * @brief Donne le nombre d'actions de l'historique.
+     *
+     * @return Le nombre d'actions.
+     */
+    int historySize () const
+    {
+        return _actions.size();
+    }
+    /**
+     * @brief Donne la mémoire estimée occupée par l'historique des actions.
+     *
+     * @return La mémoire estimée, en octets.
+     */
+    int historyMemory () const
+    {
+        return _historyMemory;
+    }
+    /**
+     * @brief Change le délais de fusion des actions.
+     *
+     * Une action effectuée moins de `msec` millisecondes après la précédente
+     * est fusionnée avec celle-ci si elles sont compatibles (Action::merge).
+     *
+     * @param msec Le délais en millisecondes, 0 pour ne fusionner qu'entre
+     *             beginMerge et endMerge
+     */
+    void setMergeInterval (int msec)
+    {
+        _mergeInterval = msec;
+    }
+    /**
+     * @brief Ouvre un groupe de fusion.
+     *
+     * Jusqu'à l'appel de endMerge, les actions compatibles successives sont
+     * fusionnées en une seule entrée de l'historique (ex: un glisser de la
+     * souris). Les groupes peuvent être imbriqués.
+     */
+    void beginMerge ()
+    {
+        if (_mergeDepth++ == 0) {
+            _mergeable = false;
+        }
+    }
+    /**
+     * @brief Ferme un groupe de fusion.
+     *
+     * @see beginMerge
+     */
+    void endMerge ()
+    {
+        if (_mergeDepth > 0 && --_mergeDepth == 0) {
+            _mergeable = false;
+        }
+    }
+    /**
+     * @brief Active ou désactive la notification différée.
+     *
+     * Lorsqu'elle est active, les notifications sont regroupées et envoyées
+     * une seule fois par tour de la boucle d'évènements.
+     *
+     * @param deferred `true` pour différer les notifications
+     */
+    void setDeferredNotify (bool deferred)
+    {
+        if (deferred && _scheduler == 0) {
+            _scheduler = new NotifyScheduler(this);
+        } else if (!deferred && _scheduler != 0) {
+            delete _scheduler;
+            _scheduler = 0;
+            flushNotify();
+        }
+    }
+    /**
+     * @brief Ouvre une transaction de notification.
+     *
+     * Jusqu'à l'appel de endNotify, les notifications sont regroupées. Les
+     * transactions peuvent être imbriquées.
+     */
+    void beginNotify ()
+    {
+        _notifyDepth++;
+    }
+    /**
+     * @brief Ferme une transaction de notification et envoie les
+     *        notifications regroupées.
+     *
+     * @see beginNotify
+     */
+    void endNotify ()
+    {
+        if (_notifyDepth > 0 && --_notifyDepth == 0) {
+            flushNotify();
+        }
+    }
+    /**
+     * @brief Envoie immédiatement les notifications en attente.
+     */
+    void flushNotify ()
+    {
+        if (_notifyDepth == 0) {
+            _sendPendingNotify();
+        }
     }
 
 protected:
@@ -125,9 +261,47 @@ protected:
      * @brief Constructeur de modèle.
      */
     Model () :
-        _saveReference(0)
+        _currentAction(0),
+        _saveReference(0),
+        _maxActions(0),
+        _maxMemory(0),
+        _historyMemory(0),
+        _mergeInterval(0),
+        _mergeDepth(0),
+        _mergeable(false),
+        _scheduler(0),
+        _notifyDepth(0),
+        _notifyPending(false)
+    {}
+    /**
+     * @brief Constructeur de copie de modèle.
+     *
+     * Ni les vues ni l'historique des actions ne sont copiés.
+     */
+    Model (const Model &other) :
+        _currentAction(0),
+        _saveReference(0),
+        _maxActions(other._maxActions),
+        _maxMemory(other._maxMemory),
+        _historyMemory(0),
+        _mergeInterval(other._mergeInterval),
+        _mergeDepth(0),
+        _mergeable(false),
+        _scheduler(0),
+        _notifyDepth(0),
+        _notifyPending(false)
+    {}
+    /**
+     * @brief Affectation de modèle.
+     *
+     * Les vues attachées sont conservées, l'historique des actions est vidé
+     * car il ne correspond plus aux données affectées.
+     */
+    Model &operator= (const Model &)
     {
-        _currentAction = _actions.end();
+        clearActions();
+        _saveReference = 0;
+        return *this;
     }
     /**
      * @brief Exécute une action.
@@ -142,6 +316,10 @@ protected:
      * Ainsi il est possible de donner un type spécifique aux actions et de
      * notifier les vues de la manière la plus appropriée.
      *
+     * Si l'action peut être fusionnée avec la précédente (voir beginMerge et
+     * setMergeInterval), elle est détruite après son exécution et la
+     * notification porte sur l'action fusionnée.
+     *
      * @param action L'action à exécuter.
      *
      * @see Action, View
@@ -149,16 +327,37 @@ protected:
     void doAction (Action *action)
     {
         if (canRedo()) {
-            QList<Action *>::iterator it = _currentAction;
-            for (; it != _actions.end(); it++) {
-                delete *it;
+            if (_saveReference > _currentAction) {
+                _saveReference = -1;
+            }
+            while (_actions.size() > _currentAction) {
+                delete _actions.takeLast();
+                _historyMemory -= _actionsMemory.takeLast();
             }
-            _actions.erase(_currentAction, _actions.end());
         }
-        _actions.push_back(action);
-        _currentAction = _actions.end();
         action->execute();
+        if (_canMerge() && _actions.last()->merge(action)) {
+            delete action;
+            action = _actions.last();
+            _historyMemory -= _actionsMemory.last();
+            _actionsMemory.last() = action->memoryUsage();
+            _historyMemory += _actionsMemory.last();
+            if (_saveReference == _currentAction) {
+                _saveReference = -1;
+            }
+            _lastAction.start();
+            _notifyAction(action);
+            _trimHistory();
+            return;
+        }
+        _actions.push_back(action);
+        _actionsMemory.push_back(action->memoryUsage());
+        _historyMemory += _actionsMemory.last();
+        _currentAction = _actions.size();
+        _mergeable = true;
+        _lastAction.start();
         _notifyAction(action);
+        _trimHistory();
     }
     /**
      * @brief Permet d'effectuer une notification personnalisé sur les vues du
@@ -170,6 +369,13 @@ protected:
      */
     void userNotify (int userType)
     {
+        if (_isNotifyDeferred()) {
+            if (!_pendingUserTypes.contains(userType)) {
+                _pendingUserTypes.push_back(userType);
+            }
+            _scheduleNotify();
+            return;
+        }
         for (int i = 0; i < _views.size(); i++) {
             onUserNotify(userType, _views[i]);
         }
@@ -192,6 +398,44 @@ protected:
      * @param view     La vue à notifier.
      */
     virtual void onUserNotify (int userType, type_View *view) = 0;
+    /**
+     * @brief Appelée une seule fois pour une action non basique lorsque les
+     *         notifications sont différées.
+     *
+     * Le modèle peut y mémoriser ce que l'action a modifié afin de notifier
+     * les vues dans onDeferredNotify. Une action qui n'est pas prise en
+     * charge est notifiée immédiatement par Model::onActionNotify.
+     *
+     * @param action L'action exécutée.
+     *
+     * @return `true` si la notification de l'action est différée.
+     */
+    virtual bool onActionDefer (Action *action)
+    {
+        return false;
+    }
+    /**
+     * @brief Appelée pour chaque vue lors de l'envoi des notifications
+     *         différées.
+     *
+     * Par défaut, appelle Model::onUserNotify pour chaque type de
+     * notification personnalisée en attente.
+     *
+     * @param userTypes Les types de notification personnalisée en attente.
+     * @param view      La vue à notifier.
+     */
+    virtual void onDeferredNotify (const QList<int> &userTypes, type_View *view)
+    {
+        for (int i = 0; i < userTypes.size(); i++) {
+            onUserNotify(userTypes[i], view);
+        }
+    }
+    /**
+     * @brief Appelée après l'envoi des notifications différées à toutes les
+     *         vues, pour oublier ce qui a été mémorisé par onActionDefer.
+     */
+    virtual void clearDeferredNotify ()
+    {}
     /**
      * @brief Vérifie la référence de sauvegarde du modèle.
      *
@@ -199,27 +443,119 @@ protected:
      */
     bool checkSaveReference () const
     {
-        if (_saveReference == 0) {
-            return !canUndo();
-        }
-        return _saveReference == *(_currentAction - 1);
+        return _saveReference == _currentAction;
     }
     /**
      * @brief Fait pointer la référence de sauvegarde sur l'état courant.
      */
     void resetSaveReference ()
     {
-        _saveReference = *(_currentAction - 1);
+        _saveReference = _currentAction;
+        _mergeable = false;
     }
 
 private:
     QList<type_View *> _views;
     QList<Action *> _actions;
-    QList<Action *>::iterator _currentAction;
-    Action *_saveReference;
+    QList<int> _actionsMemory;
+    /** Le nombre d'actions effectuées (position dans l'historique). */
+    int _currentAction;
+    /** La position de sauvegarde dans l'historique, -1 si inaccessible. */
+    int _saveReference;
+    int _maxActions;
+    int _maxMemory;
+    int _historyMemory;
+    int _mergeInterval;
+    int _mergeDepth;
+    /** Vrai si la dernière action de l'historique peut être fusionnée. */
+    bool _mergeable;
+    QElapsedTimer _lastAction;
+    NotifyScheduler *_scheduler;
+    int _notifyDepth;
+    bool _notifyPending;
+    QList<QString> _pendingMessages;
+    QList<int> _pendingUserTypes;
+
+    bool _canMerge () const
+    {
+        if (!_mergeable || _currentAction == 0) {
+            return false;
+        }
+        return _mergeDepth > 0 || (
+            _mergeInterval > 0 && _lastAction.elapsed() < _mergeInterval
+        );
+    }
+
+    void _trimHistory ()
+    {
+        while (
+            _currentAction > 1 && (
+                (_maxActions > 0 && _actions.size() > _maxActions) ||
+                (_maxMemory > 0 && _historyMemory > _maxMemory)
+            )
+        ) {
+            delete _actions.takeFirst();
+            _historyMemory -= _actionsMemory.takeFirst();
+            _currentAction--;
+            if (_saveReference >= 0) {
+                _saveReference--;
+            }
+        }
+    }
+
+    bool _isNotifyDeferred () const
+    {
+        return _notifyDepth > 0 || _scheduler != 0;
+    }
+
+    void _scheduleNotify ()
+    {
+        _notifyPending = true;
+        if (_notifyDepth == 0 && _scheduler != 0) {
+            _scheduler->schedule();
+        }
+    }
+
+    void _sendPendingNotify ()
+    {
+        if (!_notifyPending) {
+            return;
+        }
+        _notifyPending = false;
+        if (_scheduler != 0) {
+            _scheduler->cancel();
+        }
+        QList<QString> messages = _pendingMessages;
+        QList<int> userTypes = _pendingUserTypes;
+        _pendingMessages.clear();
+        _pendingUserTypes.clear();
+        for (int i = 0; i < _views.size(); i++) {
+            for (int j = 0; j < messages.size(); j++) {
+                _views[i]->simpleRefresh(messages[j]);
+            }
+            onDeferredNotify(userTypes, _views[i]);
+        }
+        clearDeferredNotify();
+    }
 
     void _notifyAction (Action *action)
     {
+        if (_isNotifyDeferred()) {
+            if (action->isBasicAction()) {
+                if (!_pendingMessages.contains(action->message())) {
+                    _pendingMessages.push_back(action->message());
+                }
+                _scheduleNotify();
+                return;
+            }
+            if (onActionDefer(action)) {
+                _scheduleNotify();
+                return;
+            }
+            // Les vues doivent recevoir les notifications dans l'ordre de
+            // l'historique : celles en attente passent avant cette action.
+            _sendPendingNotify();
+        }
         for (int i = 0; i < _views.size(); i++) {
             if (action->isBasicAction()) {
                 _views[i]->simpleRefresh(action->message());
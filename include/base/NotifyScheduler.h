@@ -0,0 +1,93 @@
+/*
+ * Solarus Quest Creator - GUI to build games for Solarus engine
+ * Copyright (C) 2013, Van den Branden Maxime <max.van.den.branden@gmail.com>
+ *
+ * Licensed under the EUPL, Version 1.1
+ * You may not use this work except in compliance with the Licence.
+ * You may obtain a copy of the Licence at:
+ *
+ * http://ec.europa.eu/idabc/eupl
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the Licence is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the Licence for the specific language governing permissions and
+ * limitations under the Licence.
+ */
+#ifndef NOTIFY_SCHEDULER_H
+#define NOTIFY_SCHEDULER_H
+
+#include <QObject>
+
+/**
+ * @brief Classe abstraite d'un objet dont les notifications sont différées.
+ *
+ * @see NotifyScheduler, Model
+ */
+class DeferredNotifier
+{
+public:
+    virtual ~DeferredNotifier ()
+    {}
+    /**
+     * @brief Envoie les notifications en attente.
+     */
+    virtual void flushNotify () = 0;
+};
+
+/**
+ * @brief Planifie l'envoi des notifications différées d'un modèle.
+ *
+ * Les demandes successives sont regroupées : les notifications ne sont
+ * envoyées qu'une fois, au prochain tour de la boucle d'évènements.
+ *
+ * @see Model::setDeferredNotify
+ */
+class NotifyScheduler : public QObject
+{
+    Q_OBJECT
+public:
+    /**
+     * @brief Constructeur du planificateur.
+     *
+     * @param notifier L'objet dont les notifications sont différées
+     */
+    NotifyScheduler (DeferredNotifier *notifier) :
+        _notifier(notifier),
+        _scheduled(false)
+    {}
+    /**
+     * @brief Planifie l'envoi des notifications au prochain tour de la boucle
+     *        d'évènements.
+     */
+    void schedule ()
+    {
+        if (!_scheduled) {
+            _scheduled = true;
+            QMetaObject::invokeMethod(this, "_flush", Qt::QueuedConnection);
+        }
+    }
+    /**
+     * @brief Annule l'envoi planifié (les notifications ont déjà été
+     *        envoyées).
+     */
+    void cancel ()
+    {
+        _scheduled = false;
+    }
+
+private:
+    DeferredNotifier *_notifier;
+    bool _scheduled;
+
+private slots:
+    void _flush ()
+    {
+        if (_scheduled) {
+            _scheduled = false;
+            _notifier->flushNotify();
+        }
+    }
+};
+
+#endif
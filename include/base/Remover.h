@@ -62,6 +62,11 @@ public:
         (_model->*_add)(GroupAction<type_Id>::selection(), _values);
     }
 
+    int memoryUsage () const
+    {
+        return GroupAction<type_Id>::memoryUsage() + estimateMemory(_values);
+    }
+
 private:
     type_Model *_model;
     QList<type_SubModel> _values;
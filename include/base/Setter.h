@@ -59,6 +59,22 @@ public:
         _value = (_model->*_set)(_value);
     }
 
+    int memoryUsage () const
+    {
+        return Action::memoryUsage() + estimateMemory(_value);
+    }
+    /**
+     * @brief Fusionne deux assignations successives d'une même propriété.
+     *
+     * La valeur d'origine est conservée pour l'annulation.
+     */
+    bool merge (const Action *other)
+    {
+        const Setter *setter = dynamic_cast<const Setter *>(other);
+        return setter != 0 && setter->type() == type() &&
+            setter->_model == _model && setter->_set == _set;
+    }
+
 private:
     type_Model *_model;
     type_Property _value;
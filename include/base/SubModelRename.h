@@ -68,6 +68,12 @@ public:
         _new = tmp;
         (_model->*_rename)(_old, _new);
     }
+
+    int memoryUsage () const
+    {
+        return Action::memoryUsage() + estimateMemory(_old) +
+            estimateMemory(_new);
+    }
     /**
      * @brief Donne l'ancien identifiant du sous modèle.
      *
@@ -61,6 +61,25 @@ public:
     {
         _value = (_model->*_set)(_id, _value);
     }
+
+    int memoryUsage () const
+    {
+        return Action::memoryUsage() + estimateMemory(_id) +
+            estimateMemory(_value);
+    }
+    /**
+     * @brief Fusionne deux assignations successives d'un même sous modèle.
+     *
+     * Le sous modèle d'origine est conservé pour l'annulation.
+     */
+    bool merge (const Action *other)
+    {
+        const SubModelSetter *setter =
+            dynamic_cast<const SubModelSetter *>(other);
+        return setter != 0 && setter->type() == type() &&
+            setter->_model == _model && setter->_set == _set &&
+            setter->_id == _id;
+    }
     /**
      * @brief Donne l'identifiant du sous modèle assigné.
      *
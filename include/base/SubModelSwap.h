@@ -0,0 +1,97 @@
+/*
+ * Solarus Quest Creator - GUI to build games for Solarus engine
+ * Copyright (C) 2013, Van den Branden Maxime <max.van.den.branden@gmail.com>
+ *
+ * Licensed under the EUPL, Version 1.1
+ * You may not use this work except in compliance with the Licence.
+ * You may obtain a copy of the Licence at:
+ *
+ * http://ec.europa.eu/idabc/eupl
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the Licence is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the Licence for the specific language governing permissions and
+ * limitations under the Licence.
+ */
+#ifndef SUB_MODEL_SWAP_H
+#define SUB_MODEL_SWAP_H
+
+#include "Action.h"
+
+/**
+ * @brief Classe d'interversion de deux sous modèles.
+ *
+ * Cette classe à deux paramètres template qui représentant le type du modèle
+ * que modifie l'action et le type de l'identifiant des sous modèles.
+ * L'interversion étant sa propre inverse, seuls les deux identifiants sont
+ * mémorisés.
+ */
+template<typename type_Model, typename type_Id>
+class SubModelSwap : public Action
+{
+public:
+    /**
+     * @brief Constructeur de l'intervertisseur de sous modèles.
+     *
+     * @param model        Le modèle à éditer
+     * @param propertyName Nom de propriété pour la notification
+     * @param swap         La méthode d'interversion du modèle
+     * @param id1          L'identifiant du premier sous modèle
+     * @param id2          L'identifiant du deuxième sous modèle
+     * @param type         Le type de l'action
+     */
+    SubModelSwap (
+        type_Model *model, QString propertyName,
+        void (type_Model::*swap)(type_Id, type_Id),
+        type_Id id1, type_Id id2, int type = BASIC_ACTION
+    ) :
+        Action(propertyName, type),
+        _model(model),
+        _id1(id1),
+        _id2(id2),
+        _swap(swap)
+    {}
+
+    void execute ()
+    {
+        (_model->*_swap)(_id1, _id2);
+    }
+
+    void reverse ()
+    {
+        (_model->*_swap)(_id1, _id2);
+    }
+
+    int memoryUsage () const
+    {
+        return Action::memoryUsage() + estimateMemory(_id1) +
+            estimateMemory(_id2);
+    }
+    /**
+     * @brief Donne l'identifiant du premier sous modèle.
+     *
+     * @return L'identifiant du premier sous modèle.
+     */
+    type_Id firstId () const
+    {
+        return _id1;
+    }
+    /**
+     * @brief Donne l'identifiant du deuxième sous modèle.
+     *
+     * @return L'identifiant du deuxième sous modèle.
+     */
+    type_Id secondId () const
+    {
+        return _id2;
+    }
+
+private:
+    type_Model *_model;
+    type_Id _id1;
+    type_Id _id2;
+    void (type_Model::*_swap)(type_Id, type_Id);
+};
+
+#endif
@@ -20,11 +20,15 @@
 #include <QMainWindow>
 #include <QMap>
 #include <QModelIndex>
-#include "item/QuestTreeWidgetItem.h"
+#include "sol/types.h"
 
 class QMdiArea;
-class SQCTreeWidget;
-class QTreeWidgetItem;
+class QMenuBar;
+class QMenu;
+class QAction;
+class SQCTreeView;
+class QuestTreeModel;
+class Quest;
 class Editor;
 
 /**
@@ -47,15 +51,16 @@ private:
     QMap<QString, Quest *> _quests;
     QString _currentQuest;
     QMdiArea *_mdiArea;
-    SQCTreeWidget *_treeWidget;
+    SQCTreeView *_treeView;
+    QuestTreeModel *_questModel;
     QMenuBar *_menuBar;
     QMenu *_fileMenu;
     //QMenu *_editMenu;
     QMenu *_resourceMenu;
     QMenu *_spriteMenu;
     QAction *_openQuestAction;
+    QAction *_preloadAction;
     QAction *_newSpriteAction;
-    QMap<QString, QuestTreeWidgetItem *> _questItems;
     QMap<QString, QMap<QString, Editor *> > _editors[N_RESOURCE_TYPE];
     QMenu *_treeMenu;
     QAction *_editTreeAction;
@@ -67,10 +72,11 @@ private:
 
 private slots:
     void _openQuest ();
-    void _openEditor (QTreeWidgetItem* item, int);
+    void _setPreload (bool preload);
+    void _openEditor (const QModelIndex &index);
     void _openEditor (Quest *quest, ResourceType type, QString id);
     void _closeEditor (Editor *editor);
-    void _resourceContextMenu (QTreeWidgetItem* item, QPoint pos);
+    void _resourceContextMenu (const QModelIndex &index, QPoint pos);
     void _resourceEdit ();
     void _resourceRemove ();
     void _newSprite ();
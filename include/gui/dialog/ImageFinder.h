@@ -18,11 +18,13 @@
 #define IMAGE_FINDER_H
 
 #include <QDialog>
+#include <QPixmap>
 
 class QTreeWidget;
 class QTreeWidgetItem;
 class QGraphicsView;
 class QDialogButtonBox;
+class ImageLoader;
 
 class ImageFinder : public QDialog
 {
@@ -37,13 +39,16 @@ private:
     QGraphicsView *_graphicsView;
     QDialogButtonBox *_buttonBox;
     QString _image;
+    ImageLoader *_imageLoader;
 
     void _initWidgets ();
     void _loadImages (QString directory, QTreeWidgetItem *treeItem = 0);
+    void _showImage (const QPixmap &pix);
 
 private slots:
     void _imageChange ();
     void _doubleClick ();
+    void _imageLoaded (QString path, QPixmap pix);
 };
 
 #endif
@@ -63,6 +63,17 @@ signals:
      * @param direction La direction d'animation
      */
     void directDirectionChange (SpriteDirection direction);
+    /**
+     * @brief Emit lorsque le focus entre dans l'éditeur.
+     *
+     * Les changements émis jusqu'à editingFinished forment une même session
+     * d'édition.
+     */
+    void editingStarted ();
+    /**
+     * @brief Emit lorsque le focus quitte l'éditeur.
+     */
+    void editingFinished ();
 
 private:
     SpriteDirection _direction;
@@ -74,6 +85,7 @@ private:
     QSpinBox *_originY;
     QSpinBox *_nbFrames;
     QSpinBox *_nbColumns;
+    bool _editing;
 
     void _initWidgets ();
     void _refreshWidgets (const SpriteDirection &direction);
@@ -97,6 +109,8 @@ private slots:
     void _directOriginYChange ();
     void _directNbFramesChange ();
     void _directNbColumnsChange ();
+
+    void _focusChange (QWidget *old, QWidget *now);
 };
 
 #endif
@@ -33,6 +33,7 @@ class SpriteGraphicsView;
 class SpriteAnimationEditor;
 class SpriteDirectionEditor;
 class SpriteDirectionPreview;
+class ImageLoader;
 
 /**
  * @brief Editeur de Sprite.
@@ -93,6 +94,8 @@ private:
     SpriteDirectionPreview *_directionPreview;
     int _animCount;
     QPixmap _currentImage;
+    ImageLoader *_imageLoader;
+    QList<QString> _directionIconKeys;
     QComboBox *_graphicsViewZoom;
     QAction *_actionSceneBorder;
     QAction *_actionShowGrid;
@@ -109,6 +112,10 @@ private:
     void _refreshTitle ();
     void _refreshDirections (const QList<SpriteDirection> &directions);
     QString _directionName (const int &dir, const int &n);
+    QString _directionIconKey (const SpriteDirection &direction) const;
+    QPixmap _directionIcon (
+        const QString &key, const SpriteDirection &direction
+    ) const;
     void _setCurrentImage (QString imagePath);
     void _refreshDirectionEditor (
         const int &n, const SpriteDirection &direction
@@ -129,11 +136,13 @@ private slots:
     void _removeAnimation ();
     void _directionSelectionChange ();
     void _directionNewSelection (Rect selection);
+    void _directionClicked (int n);
     void _directionChange (SpriteDirection direction);
     void _directAnimationChange (SpriteAnimation animation);
     void _directDirectionChange (SpriteDirection direction);
 
     void _addDirection ();
+    void _addDirectionToggle (bool checked);
     void _removeDirection ();
     void _upDirection ();
     void _downDirection ();
@@ -142,10 +151,14 @@ private slots:
 
     void _undo ();
     void _redo ();
+    void _beginMerge ();
+    void _endMerge ();
 
     void _refreshZoom (float zoom);
     void _zoomChange ();
     void _option ();
+
+    void _imageLoaded (QString path, QPixmap pix);
 };
 
 #endif
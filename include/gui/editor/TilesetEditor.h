@@ -24,12 +24,13 @@ class QLabel;
 class QLineEdit;
 class QPushButton;
 class TilePatternListWidget;
+class TilesetGraphicsView;
 
 class TilesetEditor : public QWidget, public TilesetView
 {
     Q_OBJECT
 public:
-    TilesetEditor (const Tileset &tileset);
+    TilesetEditor (QString dataDirectory, const Tileset &tileset);
 
     Tileset tileset ();
 
@@ -52,11 +53,14 @@ private:
     QPushButton *_editImage;
     //_backgroundColor;
     TilePatternListWidget *_tilePatternTable;
+    TilesetGraphicsView *_graphicsView;
 
     void _initWidgets ();
 
 private slots:
     void _nameChange ();
+    void _patternClicked (int id);
+    void _patternsSelected (QList<int> ids);
 };
 
 #endif
@@ -20,9 +20,11 @@
 #include <QGraphicsView>
 #include <QScrollBar>
 #include <QApplication>
+#include <QTimer>
 #include "sol/types.h"
 
 class QStatusBar;
+class QLabel;
 
 class SQCGraphicsView : public QGraphicsView
 {
@@ -67,6 +69,8 @@ signals:
     void snapChange (bool);
     void gridWidthChange (int);
     void gridHeightChange (int);
+    void editingStarted ();
+    void editingFinished ();
 
 protected:
     struct ComplexSelection
@@ -91,6 +95,10 @@ protected:
     virtual bool clickOnItems (QList<QGraphicsItem *> items) {
         return false;
     }
+    virtual bool clickOnScene (int x, int y) {
+        return false;
+    }
+    virtual void hoverOnScene (int x, int y) {}
     virtual void onSelection (const Rect &selection) {
         keepSelection();
     }
@@ -106,26 +114,48 @@ protected:
     bool _snap;
 
 private:
+    struct SelectionGeometry
+    {
+        QPolygonF border;
+        QList<QLineF> innerLines;
+        QPolygonF shadow;
+        QList<QPolygonF> innerShadows;
+    };
+
     float _zoom, _zoomMin, _zoomMax;
     int _zoomFactor;
     bool _canMakeSelection;
     bool _inSelection;
+    bool _forcedSelection;
+    bool _editing;
     bool _keepSelection;
     Rect _selection;
     int _x1, _y1, _x2, _y2;
     QList<ComplexSelection> _selections;
+    QList<SelectionGeometry> _geometries;
+    bool _geometriesValid;
+    QTransform _geometriesTransform;
+    QPoint _geometriesOrigin;
     int _mx, _my;
     QStatusBar *_statusBar;
+    QLabel *_statusLabel;
+    QTimer _statusTimer;
+    Rect _statusValue;
+    bool _statusSelection;
 
     void _computeSelection ();
     void _snapToGrid (int &x, int &y, const bool &ceil = false);
+    void _drawGrid (QPainter *painter, const QRect &exposed);
+    QPixmap _gridTile (int width, int height, QColor color);
     void _drawNewSelection (QPainter *painter, const Rect &selection);
     void _drawComplexSelection (
-        QPainter *painter, const ComplexSelection &selection
+        QPainter *painter, const SelectionGeometry &geometry
     );
     void _drawComplexSelectionShadow (
-        QPainter *painter, const ComplexSelection &selection
+        QPainter *painter, const SelectionGeometry &geometry
     );
+    const QList<SelectionGeometry> &_selectionGeometries ();
+    SelectionGeometry _selectionGeometry (const ComplexSelection &selection);
     QPolygonF _complexSelectionBorder(const ComplexSelection &selection);
     QList<QLineF> _complexSelectionInnerLines (
         const ComplexSelection &selection
@@ -135,7 +165,12 @@ private:
         const ComplexSelection &selection
     );
 
+    QRect _selectionViewRect (const Rect &selection);
+
     void _refreshStatusBar ();
+
+private slots:
+    void _flushStatusBar ();
 };
 
 #endif
@@ -48,6 +48,8 @@ private:
     bool _showOrigin;
     bool _cross;
     int _originX, _originY;
+
+    QRegion _originRegion () const;
 };
 
 #endif
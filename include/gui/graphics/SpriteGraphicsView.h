@@ -19,6 +19,9 @@
 
 #include "SQCGraphicsView.h"
 
+class TiledPixmapItem;
+class Sprite;
+
 class SpriteGraphicsView : public SQCGraphicsView
 {
     Q_OBJECT
@@ -26,6 +29,9 @@ public:
     SpriteGraphicsView (QStatusBar *statusBar = 0);
 
     void setImage (const QPixmap &image);
+    void setLoading (const QSize &size);
+    void setSprite (const Sprite *sprite);
+    void setPicking (bool picking);
     void setSelection (
         const SpriteAnimation &animation, const SpriteSelection &selection
     );
@@ -34,12 +40,19 @@ public:
 
 signals:
     void newSelection (Rect);
+    void directionClicked (int);
 
 protected:
     void onSelection (const Rect &selection);
+    bool clickOnScene (int x, int y);
+    void hoverOnScene (int x, int y);
 
 private:
-    QGraphicsPixmapItem *_image;
+    TiledPixmapItem *_image;
+    QGraphicsSimpleTextItem *_loading;
+    const Sprite *_sprite;
+    QString _animation;
+    bool _picking;
 };
 
 #endif
@@ -0,0 +1,74 @@
+/*
+ * Solarus Quest Creator - GUI to build games for Solarus engine
+ * Copyright (C) 2013, Van den Branden Maxime <max.van.den.branden@gmail.com>
+ *
+ * Licensed under the EUPL, Version 1.1
+ * You may not use this work except in compliance with the Licence.
+ * You may obtain a copy of the Licence at:
+ *
+ * http://ec.europa.eu/idabc/eupl
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the Licence is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the Licence for the specific language governing permissions and
+ * limitations under the Licence.
+ */
+#ifndef TILED_PIXMAP_ITEM_H
+#define TILED_PIXMAP_ITEM_H
+
+#include <QGraphicsItem>
+#include <QPixmap>
+#include <QCache>
+
+/**
+ * @brief Item graphique affichant une grande image par tuiles.
+ *
+ * L'image est découpée en tuiles de taille fixe et seules les tuiles
+ * visibles sont dessinées. En pleine résolution, les tuiles sont lues
+ * directement dans l'image, partagée avec ImageCache. Lorsque la vue est
+ * dézoomée, chaque tuile visible est réduite à la demande et gardée dans
+ * un cache dont la taille suit celle de la vue : les tuiles qui ne sont
+ * plus visibles en sont retirées.
+ */
+class TiledPixmapItem : public QGraphicsItem
+{
+public:
+    /** Taille (en pixels) d'une tuile. */
+    static const int TILE_SIZE = 256;
+
+    /**
+     * @brief Construit un item vide.
+     *
+     * @param parent L'item parent
+     */
+    TiledPixmapItem (QGraphicsItem *parent = 0);
+
+    /**
+     * @brief Retourne l'image en pleine résolution.
+     *
+     * @return L'image.
+     */
+    QPixmap pixmap () const;
+    /**
+     * @brief Change l'image affichée.
+     *
+     * @param pixmap La nouvelle image
+     */
+    void setPixmap (const QPixmap &pixmap);
+
+    QRectF boundingRect () const;
+    void paint (
+        QPainter *painter, const QStyleOptionGraphicsItem *option,
+        QWidget *widget = 0
+    );
+
+private:
+    QPixmap _pixmap;
+    QCache<quint64, QPixmap> _tiles;
+
+    int _levelFor (qreal levelOfDetail) const;
+    QPixmap _tile (int level, int tx, int ty, const QRect &source);
+};
+
+#endif
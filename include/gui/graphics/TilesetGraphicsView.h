@@ -0,0 +1,49 @@
+/*
+ * Solarus Quest Creator - GUI to build games for Solarus engine
+ * Copyright (C) 2013, Van den Branden Maxime <max.van.den.branden@gmail.com>
+ *
+ * Licensed under the EUPL, Version 1.1
+ * You may not use this work except in compliance with the Licence.
+ * You may obtain a copy of the Licence at:
+ *
+ * http://ec.europa.eu/idabc/eupl
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the Licence is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the Licence for the specific language governing permissions and
+ * limitations under the Licence.
+ */
+#ifndef TILESET_GRAPHICS_VIEW_H
+#define TILESET_GRAPHICS_VIEW_H
+
+#include "SQCGraphicsView.h"
+
+class TiledPixmapItem;
+class Tileset;
+
+class TilesetGraphicsView : public SQCGraphicsView
+{
+    Q_OBJECT
+public:
+    TilesetGraphicsView (QStatusBar *statusBar = 0);
+
+    void setImage (const QPixmap &image);
+    void setTileset (const Tileset *tileset);
+    void setSelection (const QList<int> &selection);
+
+signals:
+    void patternClicked (int);
+    void patternsSelected (QList<int>);
+
+protected:
+    void onSelection (const Rect &selection);
+    bool clickOnScene (int x, int y);
+    void hoverOnScene (int x, int y);
+
+private:
+    TiledPixmapItem *_image;
+    const Tileset *_tileset;
+};
+
+#endif
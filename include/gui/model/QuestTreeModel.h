@@ -0,0 +1,159 @@
+/*
+ * Solarus Quest Creator - GUI to build games for Solarus engine
+ * Copyright (C) 2013, Van den Branden Maxime <max.van.den.branden@gmail.com>
+ *
+ * Licensed under the EUPL, Version 1.1
+ * You may not use this work except in compliance with the Licence.
+ * You may obtain a copy of the Licence at:
+ *
+ * http://ec.europa.eu/idabc/eupl
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the Licence is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the Licence for the specific language governing permissions and
+ * limitations under the Licence.
+ */
+#ifndef QUEST_TREE_MODEL_H
+#define QUEST_TREE_MODEL_H
+
+#include <QAbstractItemModel>
+#include <QStringList>
+#include "view/QuestView.h"
+
+/**
+ * @brief Modèle en arbre des quêtes ouvertes et de leurs ressources.
+ *
+ * Chaque quête est une ligne de premier niveau contenant un dossier par
+ * type de ressource. Les lignes d'un dossier ne sont créées que lorsque
+ * la vue le demande (fetchMore), c'est-à-dire à sa première ouverture.
+ * Les identifiants d'un dossier sont gardés triés : un ajout ou une
+ * suppression est localisé par recherche dichotomique et se traduit par
+ * une seule insertion ou suppression de ligne.
+ */
+class QuestTreeModel : public QAbstractItemModel
+{
+    Q_OBJECT
+public:
+    /**
+     * @brief Constructeur du modèle.
+     *
+     * @param parent Le parent du modèle
+     */
+    QuestTreeModel (QObject *parent = 0);
+    /**
+     * @brief Destructeur du modèle.
+     */
+    ~QuestTreeModel ();
+
+    /**
+     * @brief Ajoute une quête à la fin du modèle.
+     *
+     * Le modèle s'attache à la quête pour suivre ses ressources.
+     *
+     * @param quest La quête à ajouter
+     */
+    void addQuest (Quest *quest);
+    /**
+     * @brief Change la quête courante, affichée en gras.
+     *
+     * @param quest La nouvelle quête courante
+     */
+    void setCurrentQuest (Quest *quest);
+    /**
+     * @brief Donne la quête d'un index, quel que soit son niveau.
+     *
+     * @param index L'index
+     *
+     * @return La quête ou 0 si l'index est invalide
+     */
+    Quest *quest (const QModelIndex &index) const;
+    /**
+     * @brief Vérifie si un index correspond à une ressource.
+     *
+     * @param index L'index
+     *
+     * @return true si l'index est celui d'une ressource
+     */
+    bool isResource (const QModelIndex &index) const;
+    /**
+     * @brief Donne le type de la ressource d'un index.
+     *
+     * @param index L'index d'une ressource
+     *
+     * @return Le type de la ressource
+     */
+    ResourceType resourceType (const QModelIndex &index) const;
+    /**
+     * @brief Donne l'identifiant de la ressource d'un index.
+     *
+     * @param index L'index d'une ressource
+     *
+     * @return L'identifiant de la ressource
+     */
+    QString resourceId (const QModelIndex &index) const;
+
+    QModelIndex index (
+        int row, int column, const QModelIndex &parent = QModelIndex()
+    ) const;
+    QModelIndex parent (const QModelIndex &index) const;
+    int rowCount (const QModelIndex &parent = QModelIndex()) const;
+    int columnCount (const QModelIndex &parent = QModelIndex()) const;
+    bool hasChildren (const QModelIndex &parent = QModelIndex()) const;
+    bool canFetchMore (const QModelIndex &parent) const;
+    void fetchMore (const QModelIndex &parent);
+    QVariant data (const QModelIndex &index, int role) const;
+
+private:
+    struct Node
+    {
+        bool isFolder;
+    };
+    class QuestNode;
+    struct Folder : public Node
+    {
+        QuestNode *node;
+        ResourceType type;
+        int row;
+        bool fetched;
+        QStringList ids;
+    };
+    class QuestNode : public Node, public QuestView
+    {
+    public:
+        QuestNode (QuestTreeModel *model, Quest *quest);
+        ~QuestNode ();
+
+        void refreshResource (ResourceType type, QString id);
+        void addResource (ResourceType type, QString id);
+        void removeResource (ResourceType type, QString id);
+        void refreshPreload (int loaded, int total);
+        void refreshThumbnail (ResourceType type, QString id);
+
+        QuestTreeModel *model;
+        Quest *quest;
+        QList<Folder *> folders;
+        int loaded;
+        int total;
+
+    private:
+        Folder *_folder (ResourceType type) const;
+        void _refresh (ResourceType type, QString id);
+    };
+
+    QList<ResourceType> _types;
+    QList<QuestNode *> _nodes;
+    Quest *_current;
+
+    QModelIndex _questIndex (QuestNode *node) const;
+    QModelIndex _folderIndex (Folder *folder) const;
+    QuestNode *_questNode (const QModelIndex &index) const;
+    Folder *_folderNode (const QModelIndex &index) const;
+    Folder *_resourceFolder (const QModelIndex &index) const;
+    QVariant _questData (QuestNode *node, int role) const;
+    QVariant _folderData (Folder *folder, int role) const;
+    QVariant _resourceData (Folder *folder, QString id, int role) const;
+    QString _typeName (ResourceType type) const;
+};
+
+#endif
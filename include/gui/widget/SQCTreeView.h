@@ -14,28 +14,28 @@
  * See the Licence for the specific language governing permissions and
  * limitations under the Licence.
  */
-#ifndef SQC_TREE_WIDGET_H
-#define SQC_TREE_WIDGET_H
+#ifndef SQC_TREE_VIEW_H
+#define SQC_TREE_VIEW_H
 
-#include <QTreeWidget>
+#include <QTreeView>
 #include <QContextMenuEvent>
 
-class SQCTreeWidget : public QTreeWidget
+class SQCTreeView : public QTreeView
 {
     Q_OBJECT
 public:
-    SQCTreeWidget () {}
+    SQCTreeView () {}
 
     void contextMenuEvent (QContextMenuEvent *event)
     {
-        QTreeWidgetItem *item = itemAt(event->pos());
-        if (item != 0) {
-            emit itemContextMenu(item, event->globalPos());
+        QModelIndex index = indexAt(event->pos());
+        if (index.isValid()) {
+            emit indexContextMenu(index, event->globalPos());
         }
     }
 
 signals:
-    void itemContextMenu (QTreeWidgetItem *, QPoint);
+    void indexContextMenu (const QModelIndex &, QPoint);
 };
 
 #endif
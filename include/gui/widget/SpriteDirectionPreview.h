@@ -19,10 +19,12 @@
 
 #include <QWidget>
 #include <QTimer>
+#include <QElapsedTimer>
 #include "sol/SpriteDirection.h"
 
 class QPushButton;
 class QLabel;
+class QGraphicsPixmapItem;
 class SpriteDirectionGraphicsView;
 class ColorButton;
 
@@ -41,10 +43,14 @@ public:
 
 protected:
     void changeEvent (QEvent *event);
+    void showEvent (QShowEvent *event);
+    void hideEvent (QHideEvent *event);
 
 private:
     QPixmap _pix;
     SpriteDirection _direction;
+    QList<QPixmap> _frames;
+    QGraphicsPixmapItem *_frameItem;
     SpriteDirectionGraphicsView *_graphicsView;
     QLabel *_frame;
     QPushButton *_play;
@@ -55,16 +61,23 @@ private:
     QPushButton *_last;
     int _currentFrame;
     bool _inPlaying;
+    bool _controlsPlaying;
     int _frameDelay;
     int _frameOnLoop;
     QTimer _timer;
+    QElapsedTimer _clock;
+    int _clockFrame;
     QAction *_actionOriginPoint;
     QAction *_actionOriginCross;
 
     void _initWidgets ();
     void _connects ();
 
+    void _sliceFrames ();
     void _refreshView ();
+    void _refreshFrame ();
+    void _refreshControls ();
+    void _startClock ();
 
 private slots:
     void _playAction ();
@@ -41,6 +41,8 @@ public:
     void refreshResource (ResourceType type, QString id);
     void addResource (ResourceType type, QString id);
     void removeResource (ResourceType type, QString id);
+    void refreshPreload (int loaded, int total);
+    void refreshThumbnail (ResourceType type, QString id);
 
 private:
     Quest *_quest;
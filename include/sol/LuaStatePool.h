@@ -0,0 +1,111 @@
+/*
+ * Solarus Quest Creator - GUI to build games for Solarus engine
+ * Copyright (C) 2013, Van den Branden Maxime <max.van.den.branden@gmail.com>
+ *
+ * Licensed under the EUPL, Version 1.1
+ * You may not use this work except in compliance with the Licence.
+ * You may obtain a copy of the Licence at:
+ *
+ * http://ec.europa.eu/idabc/eupl
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the Licence is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the Licence for the specific language governing permissions and
+ * limitations under the Licence.
+ */
+#ifndef LUA_STATE_POOL_H
+#define LUA_STATE_POOL_H
+
+#include <QList>
+#include <QMutex>
+#include <lua.hpp>
+#include "exception/SQCException.h"
+
+/**
+ * @brief Réserve d'états Lua pour la lecture des fichiers de données.
+ *
+ * Chaque état est créé une seule fois, sans bibliothèque standard, avec
+ * les fonctions des fichiers de données déjà enregistrées (quest,
+ * background_color, tile_pattern). Un fichier est exécuté dans son propre
+ * environnement, si bien que l'état revient propre dans la réserve.
+ *
+ * Un état n'est utilisé que par un thread à la fois : il est emprunté
+ * avec un LuaStatePool::Lease et rendu à la destruction de celui-ci.
+ */
+class LuaStatePool
+{
+public:
+    /**
+     * @brief Emprunt d'un état Lua de la réserve.
+     */
+    class Lease
+    {
+    public:
+        /**
+         * @brief Emprunte un état à la réserve, ou en crée un nouveau.
+         */
+        Lease ();
+        /**
+         * @brief Rend l'état à la réserve.
+         *
+         * Si une exception a interrompu l'exécution d'un fichier, l'état
+         * est fermé plutôt que rendu.
+         */
+        ~Lease ();
+
+        /**
+         * @brief Donne l'état emprunté.
+         *
+         * @return L'état Lua
+         */
+        lua_State *state () const;
+        /**
+         * @brief Associe un pointeur à une clé du registre de l'état.
+         *
+         * La clé est effacée lorsque l'état est rendu.
+         *
+         * @param key     La clé dans le registre
+         * @param pointer Le pointeur à associer
+         */
+        void setUserData (const char *key, void *pointer);
+        /**
+         * @brief Exécute un fichier de données dans un nouvel environnement.
+         *
+         * @param filename Le fichier à exécuter
+         *
+         * @throw SQCException Si le fichier ne peut être chargé ou exécuté.
+         */
+        void run (QString filename) throw(SQCException);
+
+    private:
+        lua_State *_L;
+        QList<const char *> _keys;
+        bool _running;
+
+        Lease (const Lease &);
+        Lease &operator= (const Lease &);
+    };
+
+    /**
+     * @brief Change le nombre maximum d'états gardés en réserve.
+     *
+     * @param max Le nombre maximum d'états
+     */
+    static void setMaxStates (int max);
+    /**
+     * @brief Ferme tous les états en réserve.
+     */
+    static void clear ();
+
+private:
+    static QMutex _mutex;
+    static QList<lua_State *> _states;
+    static int _maxStates;
+
+    static lua_State *_acquire ();
+    static void _release (lua_State *L);
+    static lua_State *_newState ();
+};
+
+#endif
@@ -17,11 +17,14 @@
 #ifndef QUEST_H
 #define QUEST_H
 
+#include <QImage>
 #include "exception/QuestException.h"
 #include "exception/IOException.h"
 #include "Tileset.h"
 
 class QuestView;
+class ResourceLoader;
+class ThumbnailCache;
 
 /**
  * @brief Quête de jeu.
@@ -29,7 +32,8 @@ class QuestView;
 class Quest
 {
 public:
-    static Quest *load (QString directory) throw(QuestException);
+    static Quest *load (QString directory, bool preload = false)
+        throw(QuestException);
 
     void save () throw (SQCException);
     //void save (QString directory = "") throw(IOException);
@@ -62,10 +66,20 @@ public:
     bool removeTileset (QString id);
     bool removeSprite (QString id);
 
+    void preload ();
+    bool isPreloading () const;
+
+    QImage thumbnail (ResourceType type, QString id);
+    void setThumbnailTileset (QString tileset);
+
     void attach (QuestView *view);
     void detach (QuestView *view);
 
 private:
+    friend class ResourceLoader;
+    friend class ThumbnailCache;
+    friend class LuaStatePool;
+
     QString _directory;
     QString _dataDirectory;
     QString _writeDir;
@@ -73,6 +87,9 @@ private:
     QMap<QString, Resource *> _resources[N_RESOURCE_TYPE];
     QMap<QString, QString> _resourceNames[N_RESOURCE_TYPE];
     QList<QuestView *> _views;
+    ResourceLoader *_loader;
+    ThumbnailCache *_thumbnails;
+    QString _thumbnailTileset;
 
     Quest (QString directory) throw(QuestException);
 
@@ -82,6 +99,10 @@ private:
     void _saveProjectDB () throw(IOException);
 
     void _setResource (ResourceType type, QString id, Resource *resource);
+    Resource *_takePreloaded (ResourceType type, QString id);
+    void _addPreloaded (ResourceType type, QString id, Resource *resource);
+    void _notifyPreload (int loaded, int total);
+    void _notifyThumbnail (ResourceType type, QString id);
 
     static int _lua_quest (lua_State *L);
 };
@@ -29,6 +29,10 @@ public:
     /** Constante de notification pour la proriété `name`. */
     static const QString p_name;
 
+    /**
+     * @brief Destructeur de resource.
+     */
+    virtual ~Resource ();
     /**
      * @brief Donne le type de la ressource.
      *
@@ -0,0 +1,79 @@
+/*
+ * Solarus Quest Creator - GUI to build games for Solarus engine
+ * Copyright (C) 2013, Van den Branden Maxime <max.van.den.branden@gmail.com>
+ *
+ * Licensed under the EUPL, Version 1.1
+ * You may not use this work except in compliance with the Licence.
+ * You may obtain a copy of the Licence at:
+ *
+ * http://ec.europa.eu/idabc/eupl
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the Licence is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the Licence for the specific language governing permissions and
+ * limitations under the Licence.
+ */
+#ifndef RESOURCE_CACHE_H
+#define RESOURCE_CACHE_H
+
+#include <QFileInfo>
+#include "exception/SQCException.h"
+#include "sol/types.h"
+
+class QDataStream;
+class Resource;
+class Sprite;
+class Tileset;
+
+/**
+ * @brief Cache binaire des ressources analysées d'une quête.
+ *
+ * Les Sprites et Tilesets chargés sont enregistrés sous forme binaire
+ * compacte dans `.sqc-cache/resources/` du dossier de la quête. Chaque
+ * fichier du cache retient le chemin, la taille et la date de
+ * modification du fichier de données dont il provient : tant que ceux-ci
+ * ne changent pas, la ressource est relue d'une seule projection en
+ * mémoire, sans analyse ni Lua. Sinon, elle est chargée normalement et
+ * le cache est régénéré.
+ *
+ * Les méthodes sont sans état et peuvent être appelées depuis plusieurs
+ * threads à la fois.
+ */
+class ResourceCache
+{
+public:
+    /**
+     * @brief Charge une ressource en passant par le cache.
+     *
+     * @param directory Le dossier de la quête
+     * @param type      Le type de la ressource (SPRITE ou TILESET)
+     * @param id        L'identifiant de la ressource
+     * @param name      Le nom de la ressource
+     *
+     * @return La ressource chargée, 0 pour les autres types
+     *
+     * @throw SQCException Si le fichier de données ne peut être chargé.
+     */
+    static Resource *load (
+        QString directory, ResourceType type, QString id, QString name
+    ) throw(SQCException);
+
+private:
+    static QString _source (ResourceType type, QString id);
+    static QString _file (QString directory, ResourceType type, QString id);
+    static Resource *_read (
+        QString file, QString source, const QFileInfo &info,
+        ResourceType type, QString id, QString name
+    );
+    static void _write (
+        QString file, QString source, const QFileInfo &info,
+        ResourceType type, const Resource *resource
+    );
+    static Sprite *_readSprite (QDataStream &in, QString id, QString name);
+    static void _writeSprite (QDataStream &out, const Sprite *sprite);
+    static Tileset *_readTileset (QDataStream &in, QString id, QString name);
+    static void _writeTileset (QDataStream &out, const Tileset *tileset);
+};
+
+#endif
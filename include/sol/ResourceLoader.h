@@ -0,0 +1,135 @@
+/*
+ * Solarus Quest Creator - GUI to build games for Solarus engine
+ * Copyright (C) 2013, Van den Branden Maxime <max.van.den.branden@gmail.com>
+ *
+ * Licensed under the EUPL, Version 1.1
+ * You may not use this work except in compliance with the Licence.
+ * You may obtain a copy of the Licence at:
+ *
+ * http://ec.europa.eu/idabc/eupl
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the Licence is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the Licence for the specific language governing permissions and
+ * limitations under the Licence.
+ */
+#ifndef RESOURCE_LOADER_H
+#define RESOURCE_LOADER_H
+
+#include <QObject>
+#include <QMap>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QThreadPool>
+#include "types.h"
+
+class Quest;
+class Resource;
+
+/**
+ * @brief Préchargement en arrière plan des ressources d'une quête (Quest).
+ *
+ * Les ressources sont chargées en parallèle sur un pool de threads. Les
+ * ressources chargées sont remises à la quête dans le thread principal, une
+ * fois par tour de boucle d'évènements.
+ *
+ * @see Quest::preload
+ */
+class ResourceLoader : public QObject
+{
+    Q_OBJECT
+public:
+    /**
+     * @brief Constructeur du chargeur de ressources.
+     *
+     * @param quest La quête à précharger
+     */
+    ResourceLoader (Quest *quest);
+    /**
+     * @brief Destructeur du chargeur, annule les chargements en attente et
+     *        attend la fin de ceux en cours.
+     */
+    ~ResourceLoader ();
+    /**
+     * @brief Planifie le chargement d'une ressource.
+     *
+     * @param type Le type de la ressource (SPRITE ou TILESET)
+     * @param id   L'identifiant de la ressource
+     * @param name Le nom de la ressource
+     */
+    void load (ResourceType type, QString id, QString name);
+    /**
+     * @brief Récupère une ressource planifiée.
+     *
+     * Si le chargement est en cours, attend sa fin. S'il n'a pas encore
+     * commencé, il est annulé.
+     *
+     * @param type Le type de la ressource
+     * @param id   L'identifiant de la ressource
+     *
+     * @return La ressource chargée, 0 si elle n'a pas été chargée.
+     */
+    Resource *take (ResourceType type, QString id);
+    /**
+     * @brief Donne le nombre de ressources planifiées.
+     *
+     * @return Le nombre de ressources planifiées.
+     */
+    int total () const;
+    /**
+     * @brief Donne le nombre de ressources traitées.
+     *
+     * @return Le nombre de ressources traitées.
+     */
+    int loaded () const;
+
+private:
+    enum State { QUEUED, RUNNING, DONE };
+
+    struct Entry
+    {
+        State state;
+        Resource *resource;
+    };
+
+    struct Loaded
+    {
+        ResourceType type;
+        QString id;
+        Resource *resource;
+    };
+
+    class Task : public QRunnable
+    {
+    public:
+        Task (ResourceLoader *loader, ResourceType type, QString id,
+              QString name);
+        void run ();
+
+    private:
+        ResourceLoader *_loader;
+        ResourceType _type;
+        QString _id;
+        QString _name;
+    };
+
+    Quest *_quest;
+    QString _directory;
+    QThreadPool _pool;
+    mutable QMutex _mutex;
+    QWaitCondition _finished;
+    QMap<QString, Entry> _entries[N_RESOURCE_TYPE];
+    int _total;
+    int _loaded;
+    bool _canceled;
+    bool _flushPending;
+
+    void _run (ResourceType type, QString id, QString name);
+    void _scheduleFlush ();
+
+private slots:
+    void _flush ();
+};
+
+#endif
@@ -18,6 +18,8 @@
 #define SPRITE_H
 
 #include <QMap>
+#include <QPair>
+#include <QSharedData>
 #include <lua.hpp>
 #include "base/Model.h"
 #include "view/SpriteView.h"
@@ -25,6 +27,25 @@
 #include "Resource.h"
 #include "SpriteSelection.h"
 #include "SpriteAnimation.h"
+#include "util/GridIndex.h"
+
+class DataTokenizer;
+
+/** Identifiant d'une direction : le nom de l'animation et son numéro. */
+typedef QPair<QString, int> SpriteDirectionId;
+
+/**
+ * @brief Données partagées d'un Sprite.
+ *
+ * Les copies d'un Sprite partagent ces données, elles ne sont dupliquées que
+ * lors de la première modification (copy-on-write).
+ */
+class SpriteData : public QSharedData
+{
+public:
+    QMap<QString, SpriteAnimation> animations;
+    QMap<QString, GridIndex<int> > directionIndex;
+};
 
 /**
  * @brief Ressource de type Sprite.
@@ -71,7 +92,8 @@ public:
      * @brief Copie un Sprite.
      *
      * Cette méthode est nécessaire pour avoir un Sprite qui est vidé de toute
-     * actions.
+     * actions. Les données de la copie sont partagées avec ce Sprite tant que
+     * l'un des deux n'est pas modifié.
      *
      * @return La copie du Sprite.
      */
@@ -84,6 +106,17 @@ public:
      * @return `true` si l'animation existe, `false` sinon.
      */
     bool animationExists (QString name) const;
+    /**
+     * @brief Donne les directions d'une animation dont une frame contient un
+     * point.
+     *
+     * @param name Le nom de l'animation
+     * @param x    La coordonnée x du point
+     * @param y    La coordonnée y du point
+     *
+     * @return Les numéros des directions trouvées.
+     */
+    QList<int> directionsAt (QString name, int x, int y) const;
     /**
      * @brief Donne une animation du Sprite.
      *
@@ -155,6 +188,49 @@ public:
      * @param newName Le nouveau nom à lui donner
      */
     void renameAnimation (QString name, QString newName) throw(SQCException);
+    /**
+     * @brief Ajoute une direction à une animation du Sprite.
+     *
+     * Seule la direction ajoutée est mémorisée dans l'historique.
+     *
+     * @param name      Le nom de l'animation
+     * @param direction La direction à ajouter
+     *
+     * @return Le numéro de la direction ajoutée.
+     * @throw SQCException Si l'animation n'existe pas.
+     */
+    int addDirection (QString name, const SpriteDirection &direction)
+        throw(SQCException);
+    /**
+     * @brief Supprime une direction d'une animation du Sprite.
+     *
+     * @param name Le nom de l'animation
+     * @param n    Le numéro de la direction à supprimer
+     *
+     * @throw SQCException Si la direction n'existe pas.
+     */
+    void removeDirection (QString name, int n) throw(SQCException);
+    /**
+     * @brief Modifie une direction d'une animation du Sprite.
+     *
+     * @param name      Le nom de l'animation
+     * @param n         Le numéro de la direction à modifier
+     * @param direction La nouvelle direction
+     *
+     * @throw SQCException Si la direction n'existe pas.
+     */
+    void setDirection (QString name, int n, const SpriteDirection &direction)
+        throw(SQCException);
+    /**
+     * @brief Intervertit deux directions d'une animation du Sprite.
+     *
+     * @param name Le nom de l'animation
+     * @param n1   Le numéro de la première direction
+     * @param n2   Le numéro de la deuxième direction
+     *
+     * @throw SQCException Si l'une des deux directions n'existe pas.
+     */
+    void swapDirections (QString name, int n1, int n2) throw(SQCException);
     /**
      * @brief Change la sélection du Sprite.
      *
@@ -165,10 +241,16 @@ public:
 protected:
     void onActionNotify (Action *action, SpriteView *view);
     void onUserNotify (int userType, SpriteView *view);
+    bool onActionDefer (Action *action);
+    void onDeferredNotify (const QList<int> &userTypes, SpriteView *view);
+    void clearDeferredNotify ();
 
 private:
-    QMap<QString, SpriteAnimation> _animations;
+    friend class ResourceCache;
+
+    QSharedDataPointer<SpriteData> _data;
     SpriteSelection _selection;
+    QList<QString> _dirtyAnimations;
 
     QString _setName (QString name);
     SpriteAnimation _setAnimation (QString name, SpriteAnimation animation);
@@ -177,9 +259,29 @@ private:
     );
     QList<SpriteAnimation> _removeAnimations (QList<QString> names);
     void _renameAnimation (QString oldName, QString newName);
+    SpriteDirection _setDirection (
+        SpriteDirectionId id, SpriteDirection direction
+    );
+    void _addDirections (
+        QList<SpriteDirectionId> ids, QList<SpriteDirection> directions
+    );
+    QList<SpriteDirection> _removeDirections (QList<SpriteDirectionId> ids);
+    void _swapDirections (SpriteDirectionId id1, SpriteDirectionId id2);
+    void _refreshAnimation (QString name, SpriteView *view);
+    void _indexAnimation (QString name);
+    void _indexDirection (QString name, int n);
+    void _parse (DataTokenizer &in, QString filename) throw(SQCException);
+    QString _parseAnimation (DataTokenizer &in, QString filename)
+        throw(SQCException);
+    SQCException _parseError (
+        QString filename, int line, QString message
+    ) const;
+    QString _refreshedAnimation (Action *action) const;
 
     void _checkAnimationExists (QString name) const throw(SQCException);
     void _checkAnimationNExists (QString name) const throw(SQCException);
+    void _checkDirectionExists (QString name, int n) const
+        throw(SQCException);
     void _checkSelection (const SpriteSelection &selection) const
         throw(SQCException);
 };
@@ -19,6 +19,7 @@
 
 #include <QString>
 #include <QList>
+#include "base/MemoryCost.h"
 #include "SpriteDirection.h"
 
 /**
@@ -128,6 +129,16 @@ public:
      * @return Le numéro de la direction ajoutée.
      */
     int addDirection (const SpriteDirection &direction);
+    /**
+     * @brief Insère une direction dans l'animation.
+     *
+     * Si le numéro est incorrect, la direction sera ajoutée à la fin de la
+     * liste.
+     *
+     * @param n         Le numéro que prendra la direction
+     * @param direction La direction à insérer
+     */
+    void insertDirection (const int &n, const SpriteDirection &direction);
     /**
      * @brief Modifie une direction de l'animation.
      *
@@ -161,6 +172,12 @@ public:
      * @return L'animation sous forme de donnée.
      */
     QString toData () const;
+    /**
+     * @brief Estime la mémoire occupée par l'animation.
+     *
+     * @return La mémoire estimée, en octets.
+     */
+    int memoryUsage () const;
 
 private:
     QString _name;
@@ -175,4 +192,9 @@ private:
     void _checkFrameOnLoop (int frameOnLoop) const throw(SQCException);
 };
 
+inline int estimateMemory (const SpriteAnimation &animation)
+{
+    return animation.memoryUsage();
+}
+
 #endif
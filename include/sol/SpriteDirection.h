@@ -17,6 +17,7 @@
 #ifndef SPRITE_DIRECTION_H
 #define SPRITE_DIRECTION_H
 
+#include <QList>
 #include "exception/SQCException.h"
 #include "sol/types.h"
 
@@ -109,6 +110,12 @@ public:
      * @return Le nombre de colonnes.
      */
     int nbColumns () const;
+    /**
+     * @brief Donne les rectangles de toutes les frames de la direction.
+     *
+     * @return Les rectangles des frames, dans l'ordre de l'animation.
+     */
+    QList<Rect> frames () const;
     /**
      * @brief Modifie la coordonnée x de la direction.
      *
@@ -0,0 +1,143 @@
+/*
+ * Solarus Quest Creator - GUI to build games for Solarus engine
+ * Copyright (C) 2013, Van den Branden Maxime <max.van.den.branden@gmail.com>
+ *
+ * Licensed under the EUPL, Version 1.1
+ * You may not use this work except in compliance with the Licence.
+ * You may obtain a copy of the Licence at:
+ *
+ * http://ec.europa.eu/idabc/eupl
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the Licence is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the Licence for the specific language governing permissions and
+ * limitations under the Licence.
+ */
+#ifndef THUMBNAIL_CACHE_H
+#define THUMBNAIL_CACHE_H
+
+#include <QObject>
+#include <QMap>
+#include <QPair>
+#include <QMutex>
+#include <QImage>
+#include <QThreadPool>
+#include "types.h"
+
+class Quest;
+
+/**
+ * @brief Cache sur disque des miniatures des ressources d'une quête (Quest).
+ *
+ * Les miniatures sont enregistrées dans le dossier `.sqc-cache/thumbnails/`
+ * de la quête. Chaque miniature retient la date de modification du fichier
+ * `.dat` de la ressource ainsi que le chemin et la date de modification de
+ * l'image utilisée : elle n'est régénérée que si l'un d'eux a changé.
+ *
+ * Les miniatures sont lues ou générées en arrière plan ; la quête prévient
+ * ses vues lorsqu'elles sont prêtes.
+ *
+ * @see Quest::thumbnail, QuestView::refreshThumbnail
+ */
+class ThumbnailCache : public QObject
+{
+    Q_OBJECT
+public:
+    /**
+     * @brief Constructeur du cache de miniatures.
+     *
+     * @param quest   La quête
+     * @param tileset Le Tileset des animations dont l'image est `tileset`
+     * @param size    La taille des miniatures
+     */
+    ThumbnailCache (
+        Quest *quest, QString tileset = "", QSize size = QSize(32, 32)
+    );
+    /**
+     * @brief Destructeur du cache, annule les miniatures en attente et
+     *        attend la fin de celles en cours.
+     */
+    ~ThumbnailCache ();
+    /**
+     * @brief Donne la miniature d'une ressource.
+     *
+     * Si la miniature n'est pas encore prête, elle est planifiée et une
+     * image nulle est retournée.
+     *
+     * @param type Le type de la ressource (SPRITE ou TILESET)
+     * @param id   L'identifiant de la ressource
+     *
+     * @return La miniature, ou une image nulle si elle n'est pas prête.
+     */
+    QImage thumbnail (ResourceType type, QString id);
+    /**
+     * @brief Oublie la miniature d'une ressource modifiée.
+     *
+     * @param type Le type de la ressource
+     * @param id   L'identifiant de la ressource
+     */
+    void invalidate (ResourceType type, QString id);
+    /**
+     * @brief Change le Tileset des animations dont l'image est `tileset`.
+     *
+     * Les miniatures des Sprite sont oubliées. Sans Tileset, ces animations
+     * sont ignorées.
+     *
+     * @param tileset L'identifiant du Tileset
+     */
+    void setTileset (QString tileset);
+
+private:
+    struct Entry
+    {
+        bool ready;
+        int generation;
+        QImage image;
+    };
+
+    class Task : public QRunnable
+    {
+    public:
+        Task (ThumbnailCache *cache, ResourceType type, QString id,
+              QString name, int generation);
+        void run ();
+
+    private:
+        ThumbnailCache *_cache;
+        ResourceType _type;
+        QString _id;
+        QString _name;
+        int _generation;
+    };
+
+    Quest *_quest;
+    QString _dataDirectory;
+    QString _directory;
+    QString _tileset;
+    QSize _size;
+    QThreadPool _pool;
+    QMutex _mutex;
+    QMap<QString, Entry> _entries[N_RESOURCE_TYPE];
+    QList<QPair<ResourceType, QString> > _ready;
+    int _generation;
+    bool _canceled;
+    bool _flushPending;
+
+    void _run (ResourceType type, QString id, QString name, int generation);
+    QImage _load (
+        ResourceType type, QString id, QString name, QString tileset
+    );
+    QImage _generate (
+        ResourceType type, QString id, QString name, QString tileset,
+        QString &image
+    );
+    QString _file (ResourceType type, QString id) const;
+    QString _modified (QString filename) const;
+    void _scheduleFlush ();
+
+private slots:
+    void _flush ();
+};
+
+#endif
@@ -18,6 +18,7 @@
 #define TILE_PATTERN_H
 
 #include <QString>
+#include <QList>
 #include "types.h"
 #include "exception/SQCException.h"
 
@@ -156,6 +157,13 @@ public:
      * @see setPosition, setPositions
      */
     bool isAnimated () const;
+    /**
+     * @brief Donne les rectangles de toutes les frames du Pattern.
+     *
+     * @return Le rectangle de la première frame, suivi de ceux des deux
+     * autres frames si le tile est animé.
+     */
+    QList<Rect> frames () const;
     /**
      * @brief Modifie le type d'obstacle du Pattern.
      *
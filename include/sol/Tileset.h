@@ -18,13 +18,30 @@
 #define TILESET_H
 
 #include <QMap>
+#include <QSharedData>
 #include <lua.hpp>
 #include "base/Model.h"
 #include "view/TilesetView.h"
 #include "exception/SQCException.h"
 #include "Resource.h"
+#include "util/GridIndex.h"
 #include "TilePattern.h"
 
+/**
+ * @brief Données partagées d'un Tileset.
+ *
+ * Les copies d'un Tileset partagent ces données, elles ne sont dupliquées que
+ * lors de la première modification (copy-on-write).
+ */
+class TilesetData : public QSharedData
+{
+public:
+    Color backgroundColor;
+    QMap<int, TilePattern> tilePatterns;
+    GridIndex<int> patternIndex;
+    int uniquePatternId;
+};
+
 /**
  * @brief Ressource de type Tileset.
  *
@@ -91,6 +108,23 @@ public:
      * @return La liste de tout les identifiants de Tile Pattern.
      */
     QList<int> patternIds () const;
+    /**
+     * @brief Donne les Tile Pattern dont une frame contient un point.
+     *
+     * @param x La coordonnée x du point
+     * @param y La coordonnée y du point
+     *
+     * @return Les identifiants des Tile Pattern trouvés.
+     */
+    QList<int> patternsAt (int x, int y) const;
+    /**
+     * @brief Donne les Tile Pattern dont une frame intersecte une zone.
+     *
+     * @param rect La zone
+     *
+     * @return Les identifiants des Tile Pattern trouvés.
+     */
+    QList<int> patternsIn (const Rect &rect) const;
     /**
      * @brief Donne la liste de tout les Tile Pattern.
      *
@@ -195,16 +229,22 @@ public:
      * @param id L'identifiant du Tile Pattern à retirer
      */
     void unselectPattern (int id);
+    /**
+     * @brief Remplace la sélection.
+     *
+     * Les identifiants qui ne correspondent à aucun Tile Pattern sont ignorés.
+     *
+     * @param ids Les identifiants des Tile Pattern à sélectionner
+     */
+    void setSelection (QList<int> ids);
 
 protected:
     void onActionNotify (Action *action, TilesetView *view);
     void onUserNotify (int userType, TilesetView *view);
 
 private:
-    Color _backgroundColor;
-    QMap<int, TilePattern> _tilePatterns;
+    QSharedDataPointer<TilesetData> _data;
     QList<int> _selection;
-    int _uniquePatternId;
 
     QString _setName (QString name);
     Color _setBackgroundColor (Color color);
@@ -214,6 +254,39 @@ private:
 
     void _checkPatternExists (int id) const throw(SQCException);
 
+    friend class LuaStatePool;
+    friend class TilesetParser;
+    friend class ResourceCache;
+
+    enum PatternKey
+    {
+        KEY_ID,
+        KEY_GROUND,
+        KEY_DEFAULT_LAYER,
+        KEY_X,
+        KEY_Y,
+        KEY_WIDTH,
+        KEY_HEIGHT,
+        KEY_SCROLLING,
+        N_PATTERN_KEY
+    };
+
+    static const char *_keyNames[];
+    static const char *_groundNames[];
+    static const char *_scrollingNames[];
+
+    void _loadPattern (const TilePattern &pattern);
+
+    static const char *_checkPattern (
+        int id, int defaultLayer, int width, int height, int nbX, int nbY
+    );
+    static TilePattern _newPattern (
+        int id, Ground ground, int defaultLayer, int width, int height,
+        int scrolling, const int *x, const int *y, int nbPositions
+    ) throw(SQCException);
+    static void _luaRegister (lua_State *L);
+    static void _luaPushLookup (lua_State *L, const char **names, int n);
+    static int _luaLookup (lua_State *L, int index, int upvalue);
     static int _lua_backgroundColor (lua_State *L);
     static int _lua_tilePattern (lua_State *L);
     static Ground _checkGround (lua_State *L, int index);
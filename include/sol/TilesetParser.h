@@ -0,0 +1,93 @@
+/*
+ * Solarus Quest Creator - GUI to build games for Solarus engine
+ * Copyright (C) 2013, Van den Branden Maxime <max.van.den.branden@gmail.com>
+ *
+ * Licensed under the EUPL, Version 1.1
+ * You may not use this work except in compliance with the Licence.
+ * You may obtain a copy of the Licence at:
+ *
+ * http://ec.europa.eu/idabc/eupl
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the Licence is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the Licence for the specific language governing permissions and
+ * limitations under the Licence.
+ */
+#ifndef TILESET_PARSER_H
+#define TILESET_PARSER_H
+
+#include <QList>
+#include "sol/Tileset.h"
+
+/**
+ * @brief Lecteur natif des fichiers de données des Tilesets.
+ *
+ * Un fichier de Tileset n'est qu'une suite d'appels déclaratifs
+ * `background_color{...}` et `tile_pattern{...}`. Ce lecteur descendant
+ * reconnaît ce sous-ensemble de Lua directement dans le fichier projeté
+ * en mémoire, et construit les TilePattern sans interpréteur, avec les
+ * mêmes vérifications que Tileset::_lua_tilePattern.
+ *
+ * Dès que le fichier sort de ce sous-ensemble (expression, chaîne avec
+ * échappement, commentaire long, pattern invalide...), le lecteur
+ * abandonne sans rien modifier et Tileset::load exécute le fichier avec
+ * Lua, qui donne alors le résultat ou l'erreur de référence.
+ */
+class TilesetParser
+{
+public:
+    /**
+     * @brief Lit un fichier de Tileset.
+     *
+     * @param tileset  Le Tileset à remplir
+     * @param filename Le fichier à lire
+     *
+     * @return false si le fichier doit être lu par Lua, le Tileset n'a
+     * alors pas été modifié
+     */
+    static bool load (Tileset *tileset, QString filename);
+
+private:
+    enum ValueType
+    {
+        INTEGER,
+        STRING,
+        LIST
+    };
+    struct Value
+    {
+        ValueType type;
+        int integer;
+        const char *string;
+        int length;
+        int list[4];
+        int count;
+    };
+
+    const char *_current;
+    const char *_end;
+    bool _unsupported;
+    bool _hasBackgroundColor;
+    Color _backgroundColor;
+    QList<TilePattern> _patterns;
+
+    TilesetParser (const char *data, qint64 size);
+
+    bool _parse ();
+    bool _backgroundColorCall ();
+    bool _tilePatternCall ();
+    bool _value (Value *value);
+    bool _list (Value *value);
+    bool _name (const char **name, int *length);
+    bool _integer (int *value);
+    bool _string (const char **string, int *length);
+    bool _symbol (char symbol);
+    void _skipSpaces ();
+
+    static int _lookup (
+        const char **names, int n, const char *name, int length
+    );
+};
+
+#endif
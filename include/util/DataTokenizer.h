@@ -0,0 +1,99 @@
+/*
+ * Solarus Quest Creator - GUI to build games for Solarus engine
+ * Copyright (C) 2013, Van den Branden Maxime <max.van.den.branden@gmail.com>
+ *
+ * Licensed under the EUPL, Version 1.1
+ * You may not use this work except in compliance with the Licence.
+ * You may obtain a copy of the Licence at:
+ *
+ * http://ec.europa.eu/idabc/eupl
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the Licence is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the Licence for the specific language governing permissions and
+ * limitations under the Licence.
+ */
+#ifndef DATA_TOKENIZER_H
+#define DATA_TOKENIZER_H
+
+#include <QString>
+
+/**
+ * @brief Lecteur séquentiel d'un fichier de données en mémoire.
+ *
+ * Le tampon est parcouru en une seule passe, sans découper les lignes :
+ * les entiers sont lus directement dans le tampon et seuls les mots
+ * demandés sont convertis en QString. Le tampon doit rester valide tant
+ * que le lecteur est utilisé.
+ */
+class DataTokenizer
+{
+public:
+    /**
+     * @brief Constructeur du lecteur.
+     *
+     * @param data Le début du tampon
+     * @param size La taille du tampon en octets
+     */
+    DataTokenizer (const char *data, qint64 size);
+
+    /**
+     * @brief Vérifie si tout le tampon a été lu.
+     *
+     * @return true si la fin du tampon est atteinte
+     */
+    bool atEnd () const;
+    /**
+     * @brief Donne le numéro de la ligne courante, à partir de 1.
+     *
+     * @return Le numéro de la ligne courante
+     */
+    int line () const;
+    /**
+     * @brief Passe les lignes vides ou ne contenant que des espaces.
+     */
+    void skipBlankLines ();
+    /**
+     * @brief Lit un mot, jusqu'au prochain espace, tabulation ou fin de
+     * ligne.
+     *
+     * @param word Le mot lu
+     *
+     * @return false si aucun caractère n'a pu être lu
+     */
+    bool word (QString *word);
+    /**
+     * @brief Lit un entier décimal, éventuellement signé, d'au plus neuf
+     *        chiffres.
+     *
+     * @param value L'entier lu
+     *
+     * @return false si aucun chiffre n'a pu être lu ou si l'entier a plus de
+     * neuf chiffres
+     */
+    bool integer (int *value);
+    /**
+     * @brief Lit un séparateur.
+     *
+     * @param separator Le caractère attendu
+     *
+     * @return false si le caractère courant n'est pas le séparateur
+     */
+    bool separator (char separator);
+    /**
+     * @brief Lit la fin de la ligne courante (`\n` ou `\r\n`).
+     *
+     * La fin du tampon est acceptée comme fin de ligne.
+     *
+     * @return false si la ligne contient encore des caractères
+     */
+    bool endOfLine ();
+
+private:
+    const char *_current;
+    const char *_end;
+    int _line;
+};
+
+#endif
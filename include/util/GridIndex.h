@@ -0,0 +1,218 @@
+/*
+ * Solarus Quest Creator - GUI to build games for Solarus engine
+ * Copyright (C) 2013, Van den Branden Maxime <max.van.den.branden@gmail.com>
+ *
+ * Licensed under the EUPL, Version 1.1
+ * You may not use this work except in compliance with the Licence.
+ * You may obtain a copy of the Licence at:
+ *
+ * http://ec.europa.eu/idabc/eupl
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the Licence is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the Licence for the specific language governing permissions and
+ * limitations under the Licence.
+ */
+#ifndef GRID_INDEX_H
+#define GRID_INDEX_H
+
+#include <QHash>
+#include <QSet>
+#include <QList>
+#include <QPair>
+#include "sol/types.h"
+
+/**
+ * @brief Index spatial en grille uniforme.
+ *
+ * Associe à chaque identifiant un ou plusieurs rectangles et permet de
+ * retrouver rapidement les identifiants présents en un point ou dans une
+ * zone : seules les cellules de la grille touchées par la requête sont
+ * parcourues.
+ *
+ * L'index se met à jour de façon incrémentale (insert, remove).
+ *
+ * Le type `type_Id` doit pouvoir être utilisé comme clé d'un QHash.
+ */
+template<typename type_Id>
+class GridIndex
+{
+public:
+    /**
+     * @brief Construit un index vide.
+     *
+     * @param cellSize La taille (en pixels) d'une cellule de la grille
+     */
+    GridIndex (int cellSize = 64) :
+        _cellSize(cellSize)
+    {}
+
+    /**
+     * @brief Ajoute des rectangles à un identifiant.
+     *
+     * @param id    L'identifiant
+     * @param rects Les rectangles à ajouter
+     */
+    void insert (const type_Id &id, const QList<Rect> &rects)
+    {
+        for (int i = 0; i < rects.size(); i++) {
+            insert(id, rects[i]);
+        }
+    }
+    /**
+     * @brief Ajoute un rectangle à un identifiant.
+     *
+     * @param id   L'identifiant
+     * @param rect Le rectangle à ajouter
+     */
+    void insert (const type_Id &id, const Rect &rect)
+    {
+        _rects[id].push_back(rect);
+        QList<Cell> cells = _cellsOf(rect);
+        for (int i = 0; i < cells.size(); i++) {
+            _cells[cells[i]].push_back(Entry(id, rect));
+        }
+    }
+    /**
+     * @brief Retire un identifiant et tous ses rectangles de l'index.
+     *
+     * @param id L'identifiant à retirer
+     */
+    void remove (const type_Id &id)
+    {
+        QList<Rect> rects = _rects.take(id);
+        QSet<Cell> cells;
+        for (int i = 0; i < rects.size(); i++) {
+            cells.unite(QSet<Cell>::fromList(_cellsOf(rects[i])));
+        }
+        typename QSet<Cell>::ConstIterator it = cells.constBegin();
+        for (; it != cells.constEnd(); ++it) {
+            QList<Entry> &entries = _cells[*it];
+            for (int i = entries.size() - 1; i >= 0; i--) {
+                if (entries[i].id == id) {
+                    entries.removeAt(i);
+                }
+            }
+            if (entries.isEmpty()) {
+                _cells.remove(*it);
+            }
+        }
+    }
+    /**
+     * @brief Vide l'index.
+     */
+    void clear ()
+    {
+        _cells.clear();
+        _rects.clear();
+    }
+    /**
+     * @brief Vérifie si un identifiant est présent dans l'index.
+     *
+     * @param id L'identifiant
+     *
+     * @return `true` si l'identifiant est présent, `false` sinon.
+     */
+    bool contains (const type_Id &id) const
+    {
+        return _rects.contains(id);
+    }
+    /**
+     * @brief Donne les identifiants dont un rectangle contient un point.
+     *
+     * @param x La coordonnée x du point
+     * @param y La coordonnée y du point
+     *
+     * @return Les identifiants trouvés, sans doublon.
+     */
+    QList<type_Id> at (int x, int y) const
+    {
+        QList<type_Id> ids;
+        Cell cell(_cell(x), _cell(y));
+        if (!_cells.contains(cell)) {
+            return ids;
+        }
+        const QList<Entry> &entries = _cells[cell];
+        for (int i = 0; i < entries.size(); i++) {
+            const Rect &r = entries[i].rect;
+            if (
+                x >= r.x && x < r.x + r.width && y >= r.y &&
+                y < r.y + r.height && !ids.contains(entries[i].id)
+            ) {
+                ids.push_back(entries[i].id);
+            }
+        }
+        return ids;
+    }
+    /**
+     * @brief Donne les identifiants dont un rectangle intersecte une zone.
+     *
+     * @param rect La zone
+     *
+     * @return Les identifiants trouvés, sans doublon.
+     */
+    QList<type_Id> intersecting (const Rect &rect) const
+    {
+        QList<type_Id> ids;
+        QSet<type_Id> found;
+        QList<Cell> cells = _cellsOf(rect);
+        for (int i = 0; i < cells.size(); i++) {
+            if (!_cells.contains(cells[i])) {
+                continue;
+            }
+            const QList<Entry> &entries = _cells[cells[i]];
+            for (int j = 0; j < entries.size(); j++) {
+                const Rect &r = entries[j].rect;
+                if (
+                    r.x < rect.x + rect.width && rect.x < r.x + r.width &&
+                    r.y < rect.y + rect.height && rect.y < r.y + r.height &&
+                    !found.contains(entries[j].id)
+                ) {
+                    found.insert(entries[j].id);
+                    ids.push_back(entries[j].id);
+                }
+            }
+        }
+        return ids;
+    }
+
+private:
+    typedef QPair<int, int> Cell;
+
+    struct Entry
+    {
+        Entry (const type_Id &id, const Rect &rect) :
+            id(id), rect(rect)
+        {}
+
+        type_Id id;
+        Rect rect;
+    };
+
+    int _cellSize;
+    QHash<Cell, QList<Entry> > _cells;
+    QHash<type_Id, QList<Rect> > _rects;
+
+    int _cell (int v) const
+    {
+        return v >= 0 ? v / _cellSize : (v - _cellSize + 1) / _cellSize;
+    }
+    QList<Cell> _cellsOf (const Rect &rect) const
+    {
+        QList<Cell> cells;
+        if (rect.width <= 0 || rect.height <= 0) {
+            return cells;
+        }
+        int cx2 = _cell(rect.x + rect.width - 1);
+        int cy2 = _cell(rect.y + rect.height - 1);
+        for (int cy = _cell(rect.y); cy <= cy2; cy++) {
+            for (int cx = _cell(rect.x); cx <= cx2; cx++) {
+                cells.push_back(Cell(cx, cy));
+            }
+        }
+        return cells;
+    }
+};
+
+#endif
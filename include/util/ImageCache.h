@@ -0,0 +1,94 @@
+/*
+ * Solarus Quest Creator - GUI to build games for Solarus engine
+ * Copyright (C) 2013, Van den Branden Maxime <max.van.den.branden@gmail.com>
+ *
+ * Licensed under the EUPL, Version 1.1
+ * You may not use this work except in compliance with the Licence.
+ * You may obtain a copy of the Licence at:
+ *
+ * http://ec.europa.eu/idabc/eupl
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the Licence is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the Licence for the specific language governing permissions and
+ * limitations under the Licence.
+ */
+#ifndef IMAGE_CACHE_H
+#define IMAGE_CACHE_H
+
+#include <QCache>
+#include <QPixmap>
+
+/**
+ * @brief Cache d'images décodées partagé par toute l'application.
+ *
+ * Les images sont indexées par leur chemin absolu et leur date de
+ * modification : une image modifiée sur le disque est donc rechargée.
+ * Le cache est limité en mémoire (en octets), les images les moins
+ * récemment utilisées étant retirées en premier.
+ *
+ * Les pixmaps ne pouvant être manipulées que dans le thread graphique, ce
+ * cache ne doit être utilisé que depuis celui-ci.
+ */
+class ImageCache
+{
+public:
+    /**
+     * @brief Mémoire maximale par défaut du cache, en octets.
+     *
+     * Elle peut être changée par le paramètre `main_window/image_cache_memory`.
+     */
+    static const int DEFAULT_MAX_MEMORY = 256 * 1024 * 1024;
+
+    /**
+     * @brief Retourne une image, en la chargeant si elle n'est pas en cache.
+     *
+     * @param path Le chemin de l'image
+     *
+     * @return L'image, ou une image nulle si elle ne peut être chargée.
+     */
+    static QPixmap pixmap (QString path);
+    /**
+     * @brief Cherche une image dans le cache, sans la charger.
+     *
+     * @param path Le chemin de l'image
+     * @param pix  L'image trouvée
+     *
+     * @return `true` si l'image est en cache, `false` sinon.
+     */
+    static bool find (QString path, QPixmap *pix);
+    /**
+     * @brief Ajoute au cache une image décodée ailleurs.
+     *
+     * @param path  Le chemin de l'image
+     * @param image L'image décodée
+     *
+     * @return L'image convertie en pixmap.
+     */
+    static QPixmap insert (QString path, const QImage &image);
+    /**
+     * @brief Retourne la mémoire maximale utilisée par le cache.
+     *
+     * @return La mémoire maximale en octets.
+     */
+    static int maxMemory ();
+    /**
+     * @brief Change la mémoire maximale utilisée par le cache.
+     *
+     * @param bytes La mémoire maximale en octets
+     */
+    static void setMaxMemory (int bytes);
+    /**
+     * @brief Vide le cache.
+     */
+    static void clear ();
+
+private:
+    static QCache<QString, QPixmap> _cache;
+
+    static QString _key (QString path);
+    static int _cost (const QPixmap &pix);
+};
+
+#endif
@@ -0,0 +1,118 @@
+/*
+ * Solarus Quest Creator - GUI to build games for Solarus engine
+ * Copyright (C) 2013, Van den Branden Maxime <max.van.den.branden@gmail.com>
+ *
+ * Licensed under the EUPL, Version 1.1
+ * You may not use this work except in compliance with the Licence.
+ * You may obtain a copy of the Licence at:
+ *
+ * http://ec.europa.eu/idabc/eupl
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the Licence is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the Licence for the specific language governing permissions and
+ * limitations under the Licence.
+ */
+#ifndef IMAGE_LOADER_H
+#define IMAGE_LOADER_H
+
+#include <QObject>
+#include <QRunnable>
+#include <QSharedPointer>
+#include <QAtomicInt>
+#include <QImage>
+#include <QPixmap>
+
+/**
+ * @brief Chargeur d'images asynchrone.
+ *
+ * Les images sont décodées dans un thread de travail puis converties en
+ * pixmap dans le thread graphique, à leur arrivée. Chaque nouvelle demande
+ * annule la précédente : un résultat périmé n'est jamais émis.
+ *
+ * Les images chargées sont ajoutées au cache d'images partagé.
+ *
+ * @see ImageCache
+ */
+class ImageLoader : public QObject
+{
+    Q_OBJECT
+public:
+    /**
+     * @brief Construit un chargeur d'images.
+     *
+     * @param parent L'objet parent
+     */
+    ImageLoader (QObject *parent = 0);
+
+    /**
+     * @brief Demande le chargement d'une image.
+     *
+     * Le signal loaded() est émis une fois l'image décodée, à moins qu'une
+     * autre demande soit faite entre temps.
+     *
+     * @param path Le chemin de l'image
+     */
+    void load (QString path);
+    /**
+     * @brief Annule la demande en cours.
+     */
+    void cancel ();
+    /**
+     * @brief Vérifie si une image est en cours de chargement.
+     *
+     * @return `true` si une demande est en cours, `false` sinon.
+     */
+    bool isLoading () const;
+    /**
+     * @brief Retourne le chemin de la dernière image demandée.
+     *
+     * @return Le chemin, ou une chaîne vide si la demande a été annulée.
+     */
+    QString path () const;
+
+signals:
+    /**
+     * @brief Signal émis lorsque l'image demandée est chargée.
+     *
+     * @param path Le chemin de l'image
+     * @param pix  L'image, nulle si elle ne peut être chargée
+     */
+    void loaded (QString path, QPixmap pix);
+
+private:
+    QSharedPointer<QAtomicInt> _generation;
+    bool _loading;
+    QString _path;
+
+private slots:
+    void _decoded (int generation, QString path, QImage image);
+};
+
+/**
+ * @brief Tâche de décodage d'une image, exécutée par un pool de threads.
+ *
+ * La tâche est abandonnée avant le décodage si une demande plus récente a
+ * été faite au chargeur.
+ */
+class ImageDecodeTask : public QObject, public QRunnable
+{
+    Q_OBJECT
+public:
+    ImageDecodeTask (
+        QString path, int generation, QSharedPointer<QAtomicInt> current
+    );
+
+    void run ();
+
+signals:
+    void decoded (int generation, QString path, QImage image);
+
+private:
+    QString _path;
+    int _generation;
+    QSharedPointer<QAtomicInt> _current;
+};
+
+#endif
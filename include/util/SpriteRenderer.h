@@ -0,0 +1,175 @@
+/*
+ * Solarus Quest Creator - GUI to build games for Solarus engine
+ * Copyright (C) 2013, Van den Branden Maxime <max.van.den.branden@gmail.com>
+ *
+ * Licensed under the EUPL, Version 1.1
+ * You may not use this work except in compliance with the Licence.
+ * You may obtain a copy of the Licence at:
+ *
+ * http://ec.europa.eu/idabc/eupl
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the Licence is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the Licence for the specific language governing permissions and
+ * limitations under the Licence.
+ */
+#ifndef SPRITE_RENDERER_H
+#define SPRITE_RENDERER_H
+
+#include <QMap>
+#include <QMutex>
+#include <QImage>
+#include <QColor>
+#include <QRunnable>
+#include "exception/SQCException.h"
+
+class Quest;
+class Sprite;
+class SpriteAnimation;
+
+/**
+ * @brief Rendu hors écran des frames d'un Sprite.
+ *
+ * Le rendu ne repose que sur QImage : il ne nécessite aucun widget et peut
+ * être fait depuis n'importe quel thread, y compris avec la plateforme
+ * `offscreen`. Les planches d'images chargées sont gardées en mémoire et
+ * partagées entre les rendus.
+ */
+class SpriteRenderer
+{
+public:
+    /** Type du résultat d'un rendu de miniatures par lot : les miniatures
+     *  de chaque animation, indexées par identifiant de Sprite. */
+    typedef QMap<QString, QMap<QString, QImage> > Thumbnails;
+
+    /**
+     * @brief Construit un moteur de rendu.
+     *
+     * @param dataDirectory Le dossier de données d'une quête (Quest)
+     * @param tileset       Le Tileset utilisé par les animations dont
+     *                      l'image est `tileset`
+     */
+    SpriteRenderer (QString dataDirectory, QString tileset = "");
+
+    /**
+     * @brief Donne le chemin de l'image d'une animation.
+     *
+     * @param animation L'animation
+     *
+     * @return Le chemin absolu de l'image.
+     */
+    QString imagePath (const SpriteAnimation &animation) const;
+    /**
+     * @brief Rend une frame d'une animation.
+     *
+     * @param animation L'animation
+     * @param direction Le numéro de la direction
+     * @param frame     Le numéro de la frame
+     * @param background La couleur de fond de l'image rendue
+     *
+     * @return L'image de la frame.
+     *
+     * @throw SQCException Si la direction ou la frame n'existe pas.
+     */
+    QImage frame (
+        const SpriteAnimation &animation, int direction, int frame,
+        QColor background = Qt::transparent
+    ) throw(SQCException);
+    /**
+     * @brief Rend une frame d'une animation d'un Sprite.
+     *
+     * @param sprite    Le Sprite
+     * @param animation Le nom de l'animation
+     * @param direction Le numéro de la direction
+     * @param frame     Le numéro de la frame
+     *
+     * @return L'image de la frame.
+     *
+     * @throw SQCException Si l'animation, la direction ou la frame n'existe
+     * pas.
+     */
+    QImage frame (
+        const Sprite &sprite, QString animation, int direction, int frame
+    ) throw(SQCException);
+    /**
+     * @brief Rend la miniature d'une animation.
+     *
+     * La miniature est la première frame de la première direction, mise à
+     * l'échelle et centrée dans une image de la taille demandée.
+     *
+     * @param animation L'animation
+     * @param size      La taille de la miniature
+     *
+     * @return La miniature, ou une image nulle si l'animation n'a pas de
+     * direction ou que son image ne peut être chargée.
+     */
+    QImage thumbnail (const SpriteAnimation &animation, const QSize &size);
+    /**
+     * @brief Rend les miniatures de toutes les animations d'un Sprite.
+     *
+     * @param sprite Le Sprite
+     * @param size   La taille des miniatures
+     *
+     * @return Les miniatures, indexées par nom d'animation.
+     */
+    QMap<QString, QImage> thumbnails (const Sprite &sprite, const QSize &size);
+    /**
+     * @brief Rend en parallèle les miniatures de tous les Sprite d'une quête.
+     *
+     * Les Sprite sont chargés depuis le disque par les threads de rendu,
+     * cette méthode ne modifie donc pas la quête.
+     *
+     * @param quest      La quête
+     * @param tileset    Le Tileset utilisé par les animations dont l'image
+     *                   est `tileset`, comme celui choisi dans l'éditeur ;
+     *                   si vide, ces animations n'ont pas de miniature
+     * @param size       La taille des miniatures
+     * @param maxThreads Le nombre maximum de threads, 0 pour le nombre
+     *                   de coeurs
+     *
+     * @return Les miniatures de chaque Sprite.
+     */
+    static Thumbnails questThumbnails (
+        const Quest *quest, QString tileset, const QSize &size,
+        int maxThreads = 0
+    );
+    /**
+     * @brief Met une image à l'échelle et la centre dans une image de taille
+     *        fixe, en gardant ses proportions.
+     *
+     * @param image L'image
+     * @param size  La taille de l'image résultat
+     *
+     * @return L'image mise à l'échelle.
+     */
+    static QImage fit (const QImage &image, const QSize &size);
+
+private:
+    class Task : public QRunnable
+    {
+    public:
+        Task (
+            SpriteRenderer *renderer, QString id, QString name, QSize size,
+            Thumbnails *result, QMutex *mutex
+        );
+        void run ();
+
+    private:
+        SpriteRenderer *_renderer;
+        QString _id;
+        QString _name;
+        QSize _size;
+        Thumbnails *_result;
+        QMutex *_mutex;
+    };
+
+    QString _dataDirectory;
+    QString _tileset;
+    QMap<QString, QImage> _images;
+    QMutex _mutex;
+
+    QImage _image (QString path);
+};
+
+#endif
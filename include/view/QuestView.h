@@ -53,6 +53,24 @@ public:
      * @see Quest
      */
     virtual void removeResource (ResourceType type, QString id) = 0;
+    /**
+     * @brief Appelée lorsque le préchargement des ressources progresse.
+     *
+     * @param loaded Le nombre de ressources déjà traitées
+     * @param total  Le nombre total de ressources à précharger
+     *
+     * @see Quest::preload
+     */
+    virtual void refreshPreload (int loaded, int total) = 0;
+    /**
+     * @brief Appelée lorsque la miniature d'une ressource est prête.
+     *
+     * @param type Le type de la ressource
+     * @param id   L'identifiant de la ressource
+     *
+     * @see Quest::thumbnail
+     */
+    virtual void refreshThumbnail (ResourceType type, QString id) = 0;
 };
 
 #endif
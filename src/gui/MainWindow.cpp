@@ -19,18 +19,28 @@
 #include <QMenuBar>
 #include <QFileDialog>
 #include <QMessageBox>
+#include <QSettings>
 #include "gui/MainWindow.h"
-#include "gui/widget/SQCTreeWidget.h"
+#include "gui/widget/SQCTreeView.h"
+#include "gui/model/QuestTreeModel.h"
 #include "gui/editor/TilesetEditor.h"
 #include "gui/editor/SpriteEditor.h"
 #include "sol/Quest.h"
-#include "gui/item/QuestTreeWidgetItem.h"
 #include "gui/dialog/NewResourceDialog.h"
 
 #include "util/FileTools.h"
+#include "util/ImageCache.h"
 
 MainWindow::MainWindow ()
 {
+    QSettings s;
+    int imageCacheMemory = s.value(
+        "main_window/image_cache_memory", ImageCache::DEFAULT_MAX_MEMORY
+    ).toInt();
+    if (imageCacheMemory <= 0) {
+        imageCacheMemory = ImageCache::DEFAULT_MAX_MEMORY;
+    }
+    ImageCache::setMaxMemory(imageCacheMemory);
     _initWidgets();
     _initMenus();
     _connects();
@@ -49,18 +59,22 @@ MainWindow::~MainWindow ()
         }
         delete it.value();
     }
+    ImageCache::clear();
 }
 
 void MainWindow::_initWidgets ()
 {
     _mdiArea = new QMdiArea;
-    _treeWidget = new SQCTreeWidget;
+    _treeView = new SQCTreeView;
+    _questModel = new QuestTreeModel(this);
 
     //_mdiArea->setViewMode(QMdiArea::TabbedView);
-    _treeWidget->setHeaderHidden(true);
+    _treeView->setHeaderHidden(true);
+    _treeView->setUniformRowHeights(true);
+    _treeView->setModel(_questModel);
 
     QSplitter *splitter = new QSplitter;
-    splitter->addWidget(_treeWidget);
+    splitter->addWidget(_treeView);
     splitter->addWidget(_mdiArea);
     setCentralWidget(splitter);
 }
@@ -76,6 +90,12 @@ void MainWindow::_initMenus ()
     _newSpriteAction = _spriteMenu->addAction(tr("&New Sprite"));
     _openQuestAction = _fileMenu->addAction(tr("&Open Quest"));
     _openQuestAction->setShortcut(QKeySequence(tr("Ctrl+O")));
+    _preloadAction = _fileMenu->addAction(tr("&Preload resources"));
+    _preloadAction->setCheckable(true);
+    QSettings s;
+    _preloadAction->setChecked(
+        s.value("main_window/preload_resources", false).toBool()
+    );
 
     _resourceMenu->addMenu(_spriteMenu);
     _resourceMenu->setEnabled(false);
@@ -85,7 +105,7 @@ void MainWindow::_initMenus ()
     _menuBar->addMenu(_resourceMenu);
     setMenuBar(_menuBar);
 
-    _treeMenu = new QMenu(_treeWidget);
+    _treeMenu = new QMenu(_treeView);
     _editTreeAction = _treeMenu->addAction(tr("Edit"));
     _removeTreeAction = _treeMenu->addAction(tr("Remove"));
 }
@@ -94,12 +114,15 @@ void MainWindow::_connects ()
 {
     connect(_openQuestAction, SIGNAL(triggered()), this, SLOT(_openQuest()));
     connect(
-        _treeWidget, SIGNAL(itemDoubleClicked(QTreeWidgetItem *, int)),
-        this, SLOT(_openEditor(QTreeWidgetItem *, int))
+        _preloadAction, SIGNAL(toggled(bool)), this, SLOT(_setPreload(bool))
+    );
+    connect(
+        _treeView, SIGNAL(doubleClicked(const QModelIndex &)),
+        this, SLOT(_openEditor(const QModelIndex &))
     );
     connect(
-        _treeWidget, SIGNAL(itemContextMenu(QTreeWidgetItem*, QPoint)),
-        this, SLOT(_resourceContextMenu(QTreeWidgetItem*, QPoint))
+        _treeView, SIGNAL(indexContextMenu(const QModelIndex &, QPoint)),
+        this, SLOT(_resourceContextMenu(const QModelIndex &, QPoint))
     );
     connect(_newSpriteAction, SIGNAL(triggered()), this, SLOT(_newSprite()));
     connect(_editTreeAction, SIGNAL(triggered()), this, SLOT(_resourceEdit()));
@@ -122,34 +145,33 @@ void MainWindow::_openQuest ()
         return;
     }
     try {
-        Quest *quest = Quest::load(dir);
+        Quest *quest = Quest::load(dir, _preloadAction->isChecked());
         _quests[dir] = quest;
-        _questItems[dir] = new QuestTreeWidgetItem(quest);
-        _treeWidget->addTopLevelItem(_questItems[dir]);
-        if (_questItems.contains(_currentQuest)) {
-            _questItems[_currentQuest]->setBold(false);
-        }
+        _questModel->addQuest(quest);
         _currentQuest = dir;
-        _questItems[dir]->setBold(true);
+        _questModel->setCurrentQuest(quest);
         _resourceMenu->setEnabled(true);
     } catch (const QuestException &ex) {
         QMessageBox::critical(this, tr("Error"), ex.what());
     }
 }
 
-void MainWindow::_openEditor (QTreeWidgetItem* item, int)
+void MainWindow::_setPreload (bool preload)
 {
-    if (item->type() != ITEM_RESOURCE) {
+    QSettings s;
+    s.setValue("main_window/preload_resources", preload);
+}
+
+void MainWindow::_openEditor (const QModelIndex &index)
+{
+    if (!_questModel->isResource(index)) {
         return;
     }
-    QString dir = item->data(0, ROLE_QUEST).toString();
-    ResourceType type = (ResourceType)item->data(0, ROLE_TYPE).toInt();
-    QString id = item->data(0, ROLE_ID).toString();
-    if (_quests.contains(dir)) {
-        Quest *quest = _quests[dir];
-        if (quest->resourceExists(type, id)) {
-            _openEditor(quest, type, id);
-        }
+    Quest *quest = _questModel->quest(index);
+    ResourceType type = _questModel->resourceType(index);
+    QString id = _questModel->resourceId(index);
+    if (quest->resourceExists(type, id)) {
+        _openEditor(quest, type, id);
     }
 }
 
@@ -158,7 +180,14 @@ void MainWindow::_openEditor (Quest *quest, ResourceType type, QString id)
     QString dir = quest->directory();
     if (!_editors[type][dir].contains(id)) {
         if (type == SPRITE) {
-            SpriteEditor *editor = new SpriteEditor(quest, quest->sprite(id));
+            Sprite sprite(id);
+            try {
+                sprite = quest->sprite(id);
+            } catch (const QuestException &ex) {
+                QMessageBox::critical(this, tr("Error"), ex.message());
+                return;
+            }
+            SpriteEditor *editor = new SpriteEditor(quest, sprite);
             _editors[SPRITE][dir][id] = editor;
             _mdiArea->addSubWindow(editor);
             connect(
@@ -171,8 +200,10 @@ void MainWindow::_openEditor (Quest *quest, ResourceType type, QString id)
             );
         }
     }
-    _editors[type][dir][id]->show();
-    _editors[type][dir][id]->setFocus();
+    if (_editors[type][dir].contains(id)) {
+        _editors[type][dir][id]->show();
+        _editors[type][dir][id]->setFocus();
+    }
 }
 
 void MainWindow::_closeEditor (Editor *editor)
@@ -184,9 +215,9 @@ void MainWindow::_closeEditor (Editor *editor)
     _mdiArea->removeSubWindow(editor);
 }
 
-void MainWindow::_resourceContextMenu (QTreeWidgetItem* item, QPoint pos)
+void MainWindow::_resourceContextMenu (const QModelIndex &index, QPoint pos)
 {
-    if (item->type() != ITEM_RESOURCE) {
+    if (!_questModel->isResource(index)) {
         return;
     }
     _treeMenu->popup(pos);
@@ -194,13 +225,13 @@ void MainWindow::_resourceContextMenu (QTreeWidgetItem* item, QPoint pos)
 
 void MainWindow::_resourceEdit ()
 {
-    _openEditor(_treeWidget->currentItem(), 0);
+    _openEditor(_treeView->currentIndex());
 }
 
 void MainWindow::_resourceRemove ()
 {
-    QTreeWidgetItem *item = _treeWidget->currentItem();
-    if (item->type() != ITEM_RESOURCE) {
+    QModelIndex index = _treeView->currentIndex();
+    if (!_questModel->isResource(index)) {
         return;
     }
     if (QMessageBox::question(
@@ -210,22 +241,18 @@ void MainWindow::_resourceRemove ()
     ) != QMessageBox::Ok) {
         return;
     }
-    QString dir = item->data(0, ROLE_QUEST).toString();
-    ResourceType type = (ResourceType)item->data(0, ROLE_TYPE).toInt();
-    QString id = item->data(0, ROLE_ID).toString();
-    if (_quests.contains(dir))
-    {
-        Quest *quest = _quests[dir];
-        if (quest->removeResource(type, id)) {
-            try {
-                quest->save();
-                if (type == SPRITE) {
-                    QFile f(quest->dataDirectory() + "sprites/" + id + ".dat");
-                    f.remove();
-                }
-            } catch (const SQCException &ex) {
-                QMessageBox::warning(this, "warn", ex.message());
+    Quest *quest = _questModel->quest(index);
+    ResourceType type = _questModel->resourceType(index);
+    QString id = _questModel->resourceId(index);
+    if (quest->removeResource(type, id)) {
+        try {
+            quest->save();
+            if (type == SPRITE) {
+                QFile f(quest->dataDirectory() + "sprites/" + id + ".dat");
+                f.remove();
             }
+        } catch (const SQCException &ex) {
+            QMessageBox::warning(this, "warn", ex.message());
         }
     }
 }
@@ -24,6 +24,8 @@
 #include <QPushButton>
 #include "gui/dialog/ImageFinder.h"
 #include "util/FileTools.h"
+#include "util/ImageCache.h"
+#include "util/ImageLoader.h"
 
 ImageFinder::ImageFinder (QWidget *parent, QString directory) :
     QDialog(parent)
@@ -48,6 +50,10 @@ ImageFinder::ImageFinder (QWidget *parent, QString directory) :
         _treeWidget, SIGNAL(doubleClicked(QModelIndex)),
         this, SLOT(_doubleClick())
     );
+    connect(
+        _imageLoader, SIGNAL(loaded(QString,QPixmap)),
+        this, SLOT(_imageLoaded(QString,QPixmap))
+    );
     connect(_buttonBox, SIGNAL(accepted()), this, SLOT(accept()));
     connect(_buttonBox, SIGNAL(rejected()), this, SLOT(reject()));
 }
@@ -61,6 +67,7 @@ void ImageFinder::_initWidgets ()
 {
     _treeWidget = new QTreeWidget;
     _graphicsView = new QGraphicsView;
+    _imageLoader = new ImageLoader(this);
     _buttonBox = new QDialogButtonBox(
         QDialogButtonBox::Ok | QDialogButtonBox::Cancel
     );
@@ -129,10 +136,29 @@ void ImageFinder::_imageChange ()
     if (item->type() == 1) {
         _buttonBox->button(QDialogButtonBox::Ok)->setEnabled(true);
         _image = item->data(0, QTreeWidgetItem::UserType).toString();
-        QPixmap pix(_image);
-        _graphicsView->scene()->clear();
-        _graphicsView->scene()->addItem(new QGraphicsPixmapItem(pix));
-        _graphicsView->scene()->setSceneRect(pix.rect());
+        QPixmap pix;
+        if (ImageCache::find(_image, &pix)) {
+            _imageLoader->cancel();
+            _showImage(pix);
+        } else {
+            _graphicsView->scene()->clear();
+            _graphicsView->scene()->addSimpleText(tr("Loading..."));
+            _imageLoader->load(_image);
+        }
+    }
+}
+
+void ImageFinder::_showImage (const QPixmap &pix)
+{
+    _graphicsView->scene()->clear();
+    _graphicsView->scene()->addItem(new QGraphicsPixmapItem(pix));
+    _graphicsView->scene()->setSceneRect(pix.rect());
+}
+
+void ImageFinder::_imageLoaded (QString path, QPixmap pix)
+{
+    if (path == _image) {
+        _showImage(pix);
     }
 }
 
@@ -14,6 +14,7 @@
  * See the Licence for the specific language governing permissions and
  * limitations under the Licence.
  */
+#include <QApplication>
 #include <QLabel>
 #include <QSpinBox>
 #include <QGridLayout>
@@ -22,7 +23,8 @@
 #include <QGroupBox>
 #include "gui/editor/SpriteDirectionEditor.h"
 
-SpriteDirectionEditor::SpriteDirectionEditor ()
+SpriteDirectionEditor::SpriteDirectionEditor () :
+    _editing(false)
 {
     setEnabled(false);
     _initWidgets();
@@ -60,6 +62,10 @@ SpriteDirectionEditor::SpriteDirectionEditor ()
         _nbColumns, SIGNAL(valueChanged(int)),
         this, SLOT(_directNbColumnsChange())
     );
+    connect(
+        qApp, SIGNAL(focusChanged(QWidget*,QWidget*)),
+        this, SLOT(_focusChange(QWidget*,QWidget*))
+    );
 }
 
 SpriteDirection SpriteDirectionEditor::direction () const
@@ -279,3 +285,15 @@ void SpriteDirectionEditor::_directNbColumnsChange ()
     direction.setNbColumns(_nbColumns->value());
     emit directDirectionChange(direction);
 }
+
+void SpriteDirectionEditor::_focusChange (QWidget *old, QWidget *now)
+{
+    bool inside = now != 0 && isAncestorOf(now);
+    if (inside && !_editing) {
+        _editing = true;
+        emit editingStarted();
+    } else if (!inside && _editing) {
+        _editing = false;
+        emit editingFinished();
+    }
+}
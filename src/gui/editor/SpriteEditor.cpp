@@ -30,6 +30,9 @@
 #include <QSplitter>
 #include <QSpinBox>
 #include <QStatusBar>
+#include <QSettings>
+#include <QPixmapCache>
+#include <QImageReader>
 #include "gui/graphics/SpriteGraphicsView.h"
 #include "gui/editor/SpriteEditor.h"
 #include "gui/editor/SpriteAnimationEditor.h"
@@ -40,6 +43,8 @@
 #include "gui/widget/SpriteDirectionPreview.h"
 #include "gui/widget/ColorButton.h"
 #include "gui/dialog/SpriteEditorOptionDialog.h"
+#include "util/ImageCache.h"
+#include "util/ImageLoader.h"
 
 SpriteEditor::SpriteEditor (Quest *quest, const Sprite &sprite) :
     Editor(quest->directory(), SPRITE, sprite.id()),
@@ -48,6 +53,14 @@ SpriteEditor::SpriteEditor (Quest *quest, const Sprite &sprite) :
     _animCount(0)
 {
     *_sprite = sprite;
+    QSettings s;
+    s.beginGroup("sprite_editor");
+    _sprite->setHistoryLimit(
+        s.value("history_max_actions", 500).toInt(),
+        s.value("history_max_memory", 32 * 1024 * 1024).toInt()
+    );
+    _sprite->setMergeInterval(s.value("merge_interval", 500).toInt());
+    s.endGroup();
     _sprite->attach(this);
     _initWidgets();
     _initToolBar();
@@ -55,11 +68,14 @@ SpriteEditor::SpriteEditor (Quest *quest, const Sprite &sprite) :
     try {
         _sprite->setSelection(_animations->currentText());
     } catch (const SQCException &ex) {}
+    _sprite->setDeferredNotify(true);
     _connects();
 }
 
 SpriteEditor::~SpriteEditor ()
 {
+    disconnect(_graphicsView, 0, this, 0);
+    disconnect(_directionEditor, 0, this, 0);
     delete _sprite;
 }
 
@@ -186,6 +202,8 @@ void SpriteEditor::_initWidgets ()
     _animations = new QComboBox;
     QStatusBar *statusBar = new QStatusBar;
     _graphicsView = new SpriteGraphicsView(statusBar);
+    _imageLoader = new ImageLoader(this);
+    _graphicsView->setSprite(_sprite);
     _animationEditor = new SpriteAnimationEditor(_quest);
     _directions = new QListWidget;
     _directionEditor = new SpriteDirectionEditor;
@@ -393,6 +411,10 @@ void SpriteEditor::_connects ()
         _graphicsView, SIGNAL(newSelection(Rect)),
         this, SLOT(_directionNewSelection(Rect))
     );
+    connect(
+        _graphicsView, SIGNAL(directionClicked(int)),
+        this, SLOT(_directionClicked(int))
+    );
     connect(
         _directionEditor, SIGNAL(directionChange(SpriteDirection)),
         this, SLOT(_directionChange(SpriteDirection))
@@ -408,6 +430,10 @@ void SpriteEditor::_connects ()
     connect(
         _addDirectionButton, SIGNAL(clicked()), this, SLOT(_addDirection())
     );
+    connect(
+        _addDirectionButton, SIGNAL(toggled(bool)),
+        this, SLOT(_addDirectionToggle(bool))
+    );
     connect(
         _removeDirectionButton, SIGNAL(clicked()),
         this, SLOT(_removeDirection())
@@ -418,6 +444,18 @@ void SpriteEditor::_connects ()
     connect(
         _downDirectionButton, SIGNAL(clicked()), this, SLOT(_downDirection())
     );
+    connect(
+        _graphicsView, SIGNAL(editingStarted()), this, SLOT(_beginMerge())
+    );
+    connect(
+        _graphicsView, SIGNAL(editingFinished()), this, SLOT(_endMerge())
+    );
+    connect(
+        _directionEditor, SIGNAL(editingStarted()), this, SLOT(_beginMerge())
+    );
+    connect(
+        _directionEditor, SIGNAL(editingFinished()), this, SLOT(_endMerge())
+    );
     connect(_actionSave, SIGNAL(triggered()), this, SLOT(_save()));
     connect(_actionUndo, SIGNAL(triggered()), this, SLOT(_undo()));
     connect(_actionRedo, SIGNAL(triggered()), this, SLOT(_redo()));
@@ -470,6 +508,10 @@ void SpriteEditor::_connects ()
         this, SLOT(_zoomChange())
     );
     connect(_actionOption, SIGNAL(triggered()), this, SLOT(_option()));
+    connect(
+        _imageLoader, SIGNAL(loaded(QString,QPixmap)),
+        this, SLOT(_imageLoaded(QString,QPixmap))
+    );
 }
 
 void SpriteEditor::_firstRefresh ()
@@ -495,27 +537,67 @@ void SpriteEditor::_refreshTitle ()
     _actionSave->setEnabled(!_sprite->isSaved());
     _actionUndo->setEnabled(_sprite->canUndo());
     _actionRedo->setEnabled(_sprite->canRedo());
+    QString history = tr("Undo") + " (" + tr("$1 actions, $2 KiB") + ")";
+    history.replace("$1", QString::number(_sprite->historySize()));
+    history.replace("$2", QString::number(_sprite->historyMemory() / 1024));
+    _actionUndo->setToolTip(history);
 }
 
 void SpriteEditor::_refreshDirections (const QList<SpriteDirection> &directions)
 {
     _directions->blockSignals(true);
-    _directions->clear();
     int n = directions.size();
+    while (_directions->count() > n) {
+        delete _directions->takeItem(_directions->count() - 1);
+        _directionIconKeys.removeLast();
+    }
     for (int i = 0; i < n; i++) {
-        SpriteDirection direction = directions[i];
-        QPixmap pix = _currentImage.copy(
-            direction.x(), direction.y(),
-            direction.width(), direction.height()
-        );
+        QString key = _directionIconKey(directions[i]);
         QString str = QString::number(i) + _directionName(i, n);
-        QListWidgetItem *item = new QListWidgetItem(QIcon(pix), str);
-        item->setData(QListWidgetItem::UserType, i);
-        _directions->addItem(item);
+        if (i < _directions->count()) {
+            QListWidgetItem *item = _directions->item(i);
+            if (_directionIconKeys[i] != key) {
+                item->setIcon(QIcon(_directionIcon(key, directions[i])));
+                _directionIconKeys[i] = key;
+            }
+            if (item->text() != str) {
+                item->setText(str);
+            }
+        } else {
+            QListWidgetItem *item = new QListWidgetItem(
+                QIcon(_directionIcon(key, directions[i])), str
+            );
+            item->setData(QListWidgetItem::UserType, i);
+            _directions->addItem(item);
+            _directionIconKeys.push_back(key);
+        }
     }
     _directions->blockSignals(false);
 }
 
+QString SpriteEditor::_directionIconKey (
+    const SpriteDirection &direction
+) const {
+    return "sqc_direction_" + QString::number(_currentImage.cacheKey()) +
+        "_" + QString::number(direction.x()) +
+        "_" + QString::number(direction.y()) +
+        "_" + QString::number(direction.width()) +
+        "_" + QString::number(direction.height());
+}
+
+QPixmap SpriteEditor::_directionIcon (
+    const QString &key, const SpriteDirection &direction
+) const {
+    QPixmap pix;
+    if (!QPixmapCache::find(key, &pix)) {
+        pix = _currentImage.copy(
+            direction.x(), direction.y(), direction.width(), direction.height()
+        );
+        QPixmapCache::insert(key, pix);
+    }
+    return pix;
+}
+
 QString SpriteEditor::_directionName (const int &dir, const int &n)
 {
     QString r = tr("right"), u = tr("up"), l = tr("left"), d = tr("down");
@@ -554,8 +636,20 @@ void SpriteEditor::_setCurrentImage (QString imagePath)
     } else {
         imagePath = _quest->dataDirectory() + "sprites/" + imagePath;
     }
-    _currentImage.load(imagePath);
-    _graphicsView->setImage(_currentImage);
+    QPixmap image;
+    if (!ImageCache::find(imagePath, &image)) {
+        if (imagePath != _imageLoader->path()) {
+            _currentImage = QPixmap();
+            _graphicsView->setLoading(QImageReader(imagePath).size());
+            _imageLoader->load(imagePath);
+        }
+        return;
+    }
+    _imageLoader->cancel();
+    if (image.cacheKey() != _currentImage.cacheKey()) {
+        _currentImage = image;
+        _graphicsView->setImage(_currentImage);
+    }
 }
 
 void SpriteEditor::_refreshDirectionEditor (
@@ -580,24 +674,25 @@ void SpriteEditor::_refreshDirectionPreview (
 
 void SpriteEditor::_swapDirection (const int &n1, const int &n2)
 {
-    SpriteAnimation animation = _sprite->animation(_animations->currentText());
+    _sprite->beginNotify();
     try {
-        animation.swapDirection(n1, n2);
-        _sprite->setAnimation(animation.name(), animation);
-        _sprite->setSelection(SpriteSelection(animation.name(), n2));
+        QString name = _animations->currentText();
+        _sprite->swapDirections(name, n1, n2);
+        _sprite->setSelection(SpriteSelection(name, n2));
     } catch (const SQCException &ex) {}
+    _sprite->endNotify();
 }
 
 void SpriteEditor::_addDirection (Rect selection)
 {
+    _sprite->beginNotify();
     try {
-        SpriteAnimation animation;
-        animation= _sprite->animation(_animations->currentText());
-        int dir = animation.addDirection(SpriteDirection(selection));
-        _sprite->setAnimation(animation.name(), animation);
-        _sprite->setSelection(SpriteSelection(animation.name(), dir));
+        QString name = _animations->currentText();
+        int dir = _sprite->addDirection(name, SpriteDirection(selection));
+        _sprite->setSelection(SpriteSelection(name, dir));
         _addDirectionButton->setChecked(false);
     } catch (const SQCException &ex) {}
+    _sprite->endNotify();
 }
 
 void SpriteEditor::_nameChange ()
@@ -634,6 +729,7 @@ void SpriteEditor::_animationChange (SpriteAnimation animation)
 
 void SpriteEditor::_tilesetChange ()
 {
+    _quest->setThumbnailTileset(_animationEditor->tileset());
     refreshAnimation(_animationEditor->animation().name());
 }
 
@@ -686,14 +782,24 @@ void SpriteEditor::_directionNewSelection (Rect selection)
     }
 }
 
+void SpriteEditor::_directionClicked (int n)
+{
+    try {
+        _sprite->setSelection(
+            SpriteSelection(_sprite->selection().animation(), n)
+        );
+    } catch (const SQCException &ex) {}
+}
+
 void SpriteEditor::_directionChange (SpriteDirection direction)
 {
     int n = _directions->currentItem()->data(QListWidgetItem::UserType).toInt();
-    SpriteAnimation animation = _sprite->animation(_animations->currentText());
-    if (direction != animation.direction(n)) {
-        animation.setDirection(n, direction);
-        _sprite->setAnimation(animation.name(), animation);
-    }
+    QString name = _animations->currentText();
+    try {
+        if (direction != _sprite->animation(name).direction(n)) {
+            _sprite->setDirection(name, n, direction);
+        }
+    } catch (const SQCException &ex) {}
 }
 
 void SpriteEditor::_directAnimationChange (SpriteAnimation animation)
@@ -728,13 +834,16 @@ void SpriteEditor::_addDirection ()
     }
 }
 
+void SpriteEditor::_addDirectionToggle (bool checked)
+{
+    _graphicsView->setPicking(!checked);
+}
+
 void SpriteEditor::_removeDirection ()
 {
     int n = _directions->currentItem()->data(QListWidgetItem::UserType).toInt();
-    SpriteAnimation animation = _sprite->animation(_animations->currentText());
     try {
-        animation.removeDirection(n);
-        _sprite->setAnimation(animation.name(), animation);
+        _sprite->removeDirection(_animations->currentText(), n);
     } catch (const SQCException &ex) {}
 }
 
@@ -768,6 +877,16 @@ void SpriteEditor::_redo ()
     _refreshTitle();
 }
 
+void SpriteEditor::_beginMerge ()
+{
+    _sprite->beginMerge();
+}
+
+void SpriteEditor::_endMerge ()
+{
+    _sprite->endMerge();
+}
+
 void SpriteEditor::_refreshZoom (float zoom)
 {
     _graphicsViewZoom->setCurrentIndex(_graphicsViewZoom->findData(zoom));
@@ -790,3 +909,10 @@ void SpriteEditor::_option ()
         dialog.setSettings();
     }
 }
+
+void SpriteEditor::_imageLoaded (QString path, QPixmap pix)
+{
+    _currentImage = pix;
+    _graphicsView->setImage(pix);
+    refreshSelection(_sprite->selection());
+}
@@ -19,25 +19,33 @@
 #include <QPushButton>
 #include <QGridLayout>
 #include <QFormLayout>
-#include <QGraphicsView>
 #include "gui/editor/TilesetEditor.h"
 #include "gui/editor/TilePatternEditor.h"
 #include "gui/widget/TilePatternListWidget.h"
+#include "gui/graphics/TilesetGraphicsView.h"
+#include "util/ImageCache.h"
 
-#include <QDebug>
-
-TilesetEditor::TilesetEditor (const Tileset &tileset) :
+TilesetEditor::TilesetEditor (QString dataDirectory, const Tileset &tileset) :
     _tileset(new Tileset(""))
 {
     _initWidgets();
     *_tileset = tileset;
     _tilePatternTable->setTileset(_tileset);
+    _graphicsView->setImage(ImageCache::pixmap(
+        dataDirectory + "tilesets/" + _tileset->id() + ".tiles.png"
+    ));
+    _graphicsView->setTileset(_tileset);
+    _tileset->attach(this);
     _name->setText(_tileset->name());
     connect(_name, SIGNAL(editingFinished()), this, SLOT(_nameChange()));
-    QList<TilePattern> list = _tileset->allPatterns();
-    for (int i = 0; i < list.size(); i++) {
-        qDebug() << list[i].toLua();
-    }
+    connect(
+        _graphicsView, SIGNAL(patternClicked(int)),
+        this, SLOT(_patternClicked(int))
+    );
+    connect(
+        _graphicsView, SIGNAL(patternsSelected(QList<int>)),
+        this, SLOT(_patternsSelected(QList<int>))
+    );
 }
 
 Tileset TilesetEditor::tileset ()
@@ -52,7 +60,7 @@ void TilesetEditor::setTileset (const Tileset &tileset)
 
 void TilesetEditor::refreshSelection (QList<int> selection)
 {
-
+    _graphicsView->setSelection(selection);
 }
 
 void TilesetEditor::refreshPattern (int id)
@@ -77,6 +85,7 @@ void TilesetEditor::_initWidgets ()
     _image = new QLineEdit;
     _editImage = new QPushButton(tr("edit"));
     _tilePatternTable = new TilePatternListWidget;
+    _graphicsView = new TilesetGraphicsView;
 
     QHBoxLayout *imageLayout = new QHBoxLayout;
     imageLayout->addWidget(_image);
@@ -94,7 +103,7 @@ void TilesetEditor::_initWidgets ()
 
     QGridLayout *layout = new QGridLayout;
     layout->addLayout(leftLayout, 0, 0, 2, 1);
-    layout->addWidget(new QGraphicsView(), 0, 1);
+    layout->addWidget(_graphicsView, 0, 1);
     layout->addWidget(new TilePatternEditor(TilePattern(42)), 1, 1);
 
     layout->setColumnStretch(1, 1);
@@ -106,3 +115,13 @@ void TilesetEditor::_nameChange ()
     _tileset->setName(_name->text());
     emit tilesetChange(_tileset->copy());
 }
+
+void TilesetEditor::_patternClicked (int id)
+{
+    _tileset->setSelection(QList<int>() << id);
+}
+
+void TilesetEditor::_patternsSelected (QList<int> ids)
+{
+    _tileset->setSelection(ids);
+}
@@ -17,6 +17,9 @@
 #include <QKeyEvent>
 #include <QWheelEvent>
 #include <QStatusBar>
+#include <QLabel>
+#include <QPixmapCache>
+#include <qmath.h>
 #include "gui/graphics/SQCGraphicsView.h"
 
 SQCGraphicsView::SQCGraphicsView (QStatusBar *statusBar) :
@@ -26,8 +29,11 @@ SQCGraphicsView::SQCGraphicsView (QStatusBar *statusBar) :
     _zoomFactor(2),
     _canMakeSelection(false),
     _inSelection(false),
+    _forcedSelection(false),
+    _editing(false),
     _keepSelection(false),
     _selection((Rect){-1, -1, -1, -1}),
+    _geometriesValid(false),
     _gridW(8),
     _gridH(8),
     _selectionColor(Qt::blue),
@@ -37,9 +43,20 @@ SQCGraphicsView::SQCGraphicsView (QStatusBar *statusBar) :
     _showGrid(false),
     _gridColor(64, 64, 64),
     _gridOpacity(0.5),
-    _statusBar(statusBar)
+    _statusBar(statusBar),
+    _statusLabel(0),
+    _statusValue((Rect){-1, -1, -1, -1}),
+    _statusSelection(false)
 {
-    setViewportUpdateMode(QGraphicsView::FullViewportUpdate);
+    if (_statusBar != 0) {
+        _statusLabel = new QLabel;
+        _statusBar->addPermanentWidget(_statusLabel);
+        _statusTimer.setSingleShot(true);
+        _statusTimer.setInterval(16);
+        connect(
+            &_statusTimer, SIGNAL(timeout()), this, SLOT(_flushStatusBar())
+        );
+    }
 }
 
 void SQCGraphicsView::setMakeSelection (bool canMake)
@@ -206,9 +223,20 @@ void SQCGraphicsView::setGridHeight (int height)
 
 void SQCGraphicsView::mousePressEvent (QMouseEvent *event)
 {
+    if (!_editing) {
+        _editing = true;
+        emit editingStarted();
+    }
     clear();
-    if (!clickOnItems(items(event->pos())) && _canMakeSelection) {
-        QPointF pos = mapToScene(event->pos());
+    QPointF pos = mapToScene(event->pos());
+    _forcedSelection = _canMakeSelection &&
+        event->modifiers().testFlag(Qt::ShiftModifier);
+    bool clicked = false;
+    if (!_forcedSelection) {
+        clicked = clickOnItems(items(event->pos())) ||
+            clickOnScene(qFloor(pos.x()), qFloor(pos.y()));
+    }
+    if (!clicked && _canMakeSelection) {
         _x1 = _x2 = pos.x(); _y1 = _y2 = pos.y();
         if (_snap) {
             _snapToGrid(_x1, _y1);
@@ -217,7 +245,7 @@ void SQCGraphicsView::mousePressEvent (QMouseEvent *event)
         _computeSelection();
         _inSelection = true;
         _refreshStatusBar();
-        viewport()->repaint();
+        viewport()->update();
     }
 }
 
@@ -225,6 +253,9 @@ void SQCGraphicsView::mouseMoveEvent (QMouseEvent *event)
 {
     QPointF pos = mapToScene(event->pos());
     _mx = pos.x(); _my = pos.y();
+    if (!_inSelection) {
+        hoverOnScene(qFloor(pos.x()), qFloor(pos.y()));
+    }
     if (_snap) {
         _snapToGrid(_mx, _my);
     }
@@ -238,8 +269,17 @@ void SQCGraphicsView::mouseMoveEvent (QMouseEvent *event)
                 _y2 += _gridH;
             }
         }
+        Rect old = _selection;
         _computeSelection();
-        viewport()->repaint();
+        if (
+            _selection.x != old.x || _selection.y != old.y ||
+            _selection.width != old.width || _selection.height != old.height
+        ) {
+            viewport()->update(
+                QRegion(_selectionViewRect(old)) |
+                QRegion(_selectionViewRect(_selection))
+            );
+        }
     }
     _refreshStatusBar();
 }
@@ -249,7 +289,11 @@ void SQCGraphicsView::mouseReleaseEvent (QMouseEvent *event)
     if (_inSelection) {
         _inSelection = false;
         onSelection(_selection);
-        viewport()->repaint();
+        viewport()->update(_selectionViewRect(_selection));
+    }
+    if (_editing && event->buttons() == Qt::NoButton) {
+        _editing = false;
+        emit editingFinished();
     }
 }
 
@@ -265,29 +309,21 @@ void SQCGraphicsView::paintEvent (QPaintEvent *event)
         painter.drawRect(polygon.boundingRect().adjusted(-1, -1, 0, 0));
     }
     if (_showGrid) {
-        QColor gridColor = _gridColor;
-        gridColor.setAlpha(_gridOpacity * 255);
-        painter.setPen(gridColor);
-        int w = sceneRect().width(), h = sceneRect().height();
-        for (int x = _gridW; x < w; x += _gridW) {
-            painter.drawLine(mapFromScene(x, 0), mapFromScene(x, h));
-        }
-        for (int y = _gridH; y < h; y += _gridH) {
-            painter.drawLine(mapFromScene(0, y), mapFromScene(w, y));
-        }
+        _drawGrid(&painter, event->rect());
     }
     if (_selections.size()) {
+        const QList<SelectionGeometry> &geometries = _selectionGeometries();
         if (_displaySelectionShadow) {
             QColor shadowColor = _selectionColor;
             shadowColor.setAlpha(85);
             painter.setPen(shadowColor);
-            for (int i = 0; i < _selections.size(); i++) {
-                _drawComplexSelectionShadow(&painter, _selections[i]);
+            for (int i = 0; i < geometries.size(); i++) {
+                _drawComplexSelectionShadow(&painter, geometries[i]);
             }
         }
         painter.setPen(_selectionColor);
-        for (int i = 0; i < _selections.size(); i++) {
-            _drawComplexSelection(&painter, _selections[i]);
+        for (int i = 0; i < geometries.size(); i++) {
+            _drawComplexSelection(&painter, geometries[i]);
         }
     } else if (_inSelection || _keepSelection) {
         _drawNewSelection(&painter, _selection);
@@ -323,6 +359,7 @@ void SQCGraphicsView::clear ()
     _selection = (Rect){-1, -1, -1, -1};
     _keepSelection = false;
     _selections.clear();
+    _geometriesValid = false;
 }
 
 void SQCGraphicsView::setNewSelection (Rect selection)
@@ -338,6 +375,7 @@ void SQCGraphicsView::keepSelection ()
 void SQCGraphicsView::addToSelection (const ComplexSelection &selection)
 {
     _selections.push_back(selection);
+    _geometriesValid = false;
 }
 
 void SQCGraphicsView::_computeSelection ()
@@ -368,45 +406,123 @@ void SQCGraphicsView::_snapToGrid (int &x, int &y, const bool &ceil)
     }
 }
 
+void SQCGraphicsView::_drawGrid (QPainter *painter, const QRect &exposed)
+{
+    QColor gridColor = _gridColor;
+    gridColor.setAlpha(_gridOpacity * 255);
+    int w = sceneRect().width(), h = sceneRect().height();
+    qreal tw = _gridW * _zoom, th = _gridH * _zoom;
+    if (
+        qAbs(tw - qRound(tw)) < 0.001 && qAbs(th - qRound(th)) < 0.001 &&
+        qRound(tw) >= 2 && qRound(th) >= 2
+    ) {
+        QPoint origin = mapFromScene(0, 0);
+        QPoint end = mapFromScene(w, h);
+        QRect area(origin + QPoint(1, 1), end - QPoint(1, 1));
+        painter->setBrushOrigin(origin);
+        painter->fillRect(
+            area & exposed,
+            QBrush(_gridTile(qRound(tw), qRound(th), gridColor))
+        );
+        return;
+    }
+    QRectF rect = mapToScene(exposed).boundingRect();
+    int x1 = qMax(_gridW, ((int)rect.left() / _gridW) * _gridW);
+    int y1 = qMax(_gridH, ((int)rect.top() / _gridH) * _gridH);
+    int x2 = qMin(w - 1, (int)rect.right() + 1);
+    int y2 = qMin(h - 1, (int)rect.bottom() + 1);
+    painter->setPen(gridColor);
+    for (int x = x1; x <= x2; x += _gridW) {
+        painter->drawLine(mapFromScene(x, 0), mapFromScene(x, h));
+    }
+    for (int y = y1; y <= y2; y += _gridH) {
+        painter->drawLine(mapFromScene(0, y), mapFromScene(w, y));
+    }
+}
+
+QPixmap SQCGraphicsView::_gridTile (int width, int height, QColor color)
+{
+    QString key = "sqc_grid_" + QString::number(width) + "_" +
+        QString::number(height) + "_" + QString::number(color.rgba());
+    QPixmap tile;
+    if (!QPixmapCache::find(key, &tile)) {
+        tile = QPixmap(width, height);
+        tile.fill(Qt::transparent);
+        QPainter painter(&tile);
+        painter.setPen(color);
+        painter.drawLine(0, 0, width - 1, 0);
+        painter.drawLine(0, 0, 0, height - 1);
+        painter.end();
+        QPixmapCache::insert(key, tile);
+    }
+    return tile;
+}
+
 void SQCGraphicsView::_drawNewSelection (
     QPainter *painter, const Rect &selection
 ) {
     ComplexSelection complex = (ComplexSelection){(Rect){
         selection.x, selection.y, selection.width, selection.height
     }, 1, 1};
+    SelectionGeometry geometry = _selectionGeometry(complex);
     painter->setPen(QColor(0, 0, 0, 85));
-    _drawComplexSelectionShadow(painter, complex);
+    _drawComplexSelectionShadow(painter, geometry);
     painter->setPen(QColor(64, 64, 64));
-    _drawComplexSelection(painter, complex);
+    _drawComplexSelection(painter, geometry);
     QPen pen(Qt::DashLine);
     pen.setColor(Qt::white);
     painter->setPen(pen);
-    _drawComplexSelection(painter, complex);
+    _drawComplexSelection(painter, geometry);
 }
 
 void SQCGraphicsView::_drawComplexSelection (
-    QPainter *painter, const ComplexSelection &selection
+    QPainter *painter, const SelectionGeometry &geometry
 ) {
-    QPolygonF borderPolygon = _complexSelectionBorder(selection);
-    QList<QLineF> innerLines = _complexSelectionInnerLines(selection);
-    painter->drawPolygon(borderPolygon);
-    for (int i = 0; i < innerLines.size(); i++) {
-        painter->drawLine(innerLines[i]);
+    painter->drawPolygon(geometry.border);
+    for (int i = 0; i < geometry.innerLines.size(); i++) {
+        painter->drawLine(geometry.innerLines[i]);
     }
 }
 
 void SQCGraphicsView::_drawComplexSelectionShadow (
-    QPainter *painter, const ComplexSelection &selection
+    QPainter *painter, const SelectionGeometry &geometry
 ) {
-    QPolygonF borderPolygon = _complexSelectionBorder(selection);
-    QPolygonF shadow = _getBorderShadow(borderPolygon);
-    QList<QPolygonF> innerShadows = _complexSelectionInnerShadows(selection);
-    painter->drawPolygon(shadow);
-    for (int i = 0; i < innerShadows.size(); i++) {
-        painter->drawPolygon(innerShadows[i]);
+    painter->drawPolygon(geometry.shadow);
+    for (int i = 0; i < geometry.innerShadows.size(); i++) {
+        painter->drawPolygon(geometry.innerShadows[i]);
     }
 }
 
+const QList<SQCGraphicsView::SelectionGeometry> &
+SQCGraphicsView::_selectionGeometries ()
+{
+    QPoint origin = mapFromScene(0, 0);
+    if (
+        !_geometriesValid || transform() != _geometriesTransform ||
+        origin != _geometriesOrigin
+    ) {
+        _geometries.clear();
+        for (int i = 0; i < _selections.size(); i++) {
+            _geometries.push_back(_selectionGeometry(_selections[i]));
+        }
+        _geometriesValid = true;
+        _geometriesTransform = transform();
+        _geometriesOrigin = origin;
+    }
+    return _geometries;
+}
+
+SQCGraphicsView::SelectionGeometry SQCGraphicsView::_selectionGeometry (
+    const ComplexSelection &selection
+) {
+    SelectionGeometry geometry;
+    geometry.border = _complexSelectionBorder(selection);
+    geometry.innerLines = _complexSelectionInnerLines(selection);
+    geometry.shadow = _getBorderShadow(geometry.border);
+    geometry.innerShadows = _complexSelectionInnerShadows(selection);
+    return geometry;
+}
+
 QPolygonF SQCGraphicsView::_complexSelectionBorder (
     const ComplexSelection &selection
 ) {
@@ -527,23 +643,39 @@ QList<QPolygonF> SQCGraphicsView::_complexSelectionInnerShadows (
     return list;
 }
 
+QRect SQCGraphicsView::_selectionViewRect (const Rect &selection)
+{
+    QRectF rect(selection.x, selection.y, selection.width, selection.height);
+    return mapFromScene(rect).boundingRect().adjusted(-2, -2, 2, 2);
+}
+
 void SQCGraphicsView::_refreshStatusBar ()
 {
     if (_statusBar == 0) {
         return;
     }
-    _statusBar->clearMessage();
-    QString msg;
-    if (_inSelection) {
-        msg = QString::number(_selection.x);
-        msg += ";" + QString::number(_selection.y);
-        msg += " - " + QString::number(_selection.width);
-        msg += "x" + QString::number(_selection.height);
-    } else {
-        msg = QString::number(_mx);
-        msg += ";" + QString::number(_my);
+    Rect value = _inSelection ? _selection : (Rect){_mx, _my, 0, 0};
+    if (
+        _inSelection == _statusSelection && value.x == _statusValue.x &&
+        value.y == _statusValue.y && value.width == _statusValue.width &&
+        value.height == _statusValue.height
+    ) {
+        return;
+    }
+    _statusValue = value;
+    _statusSelection = _inSelection;
+    if (!_statusTimer.isActive()) {
+        _statusTimer.start();
     }
-    if (msg != _statusBar->currentMessage()) {
-        _statusBar->showMessage(msg);
+}
+
+void SQCGraphicsView::_flushStatusBar ()
+{
+    QString msg = QString::number(_statusValue.x);
+    msg += ";" + QString::number(_statusValue.y);
+    if (_statusSelection) {
+        msg += " - " + QString::number(_statusValue.width);
+        msg += "x" + QString::number(_statusValue.height);
     }
+    _statusLabel->setText(msg);
 }
@@ -52,9 +52,10 @@ bool SpriteDirectionGraphicsView::cross () const
 void SpriteDirectionGraphicsView::setOrigin (int originX, int originY)
 {
     if (originX != _originX || originY != _originY) {
+        QRegion old = _originRegion();
         _originX = originX;
         _originY = originY;
-        viewport()->update();
+        viewport()->update(old | _originRegion());
     }
 }
 
@@ -121,3 +122,15 @@ void SpriteDirectionGraphicsView::paintEvent (QPaintEvent *event)
         }
     }
 }
+
+QRegion SpriteDirectionGraphicsView::_originRegion () const
+{
+    QPoint p = mapFromScene(_originX, _originY);
+    if (!_showOrigin) {
+        return QRegion();
+    } else if (_cross) {
+        int w = viewport()->width(), h = viewport()->height();
+        return QRegion(p.x() - 1, 0, 3, h) | QRegion(0, p.y() - 1, w, 3);
+    }
+    return QRegion(p.x() - 2, p.y() - 2, 5, 5);
+}
@@ -14,14 +14,18 @@
  * See the Licence for the specific language governing permissions and
  * limitations under the Licence.
  */
-#include <QGraphicsPixmapItem>
+#include <QGraphicsSimpleTextItem>
 #include <QSettings>
 #include "gui/graphics/SpriteGraphicsView.h"
+#include "gui/graphics/TiledPixmapItem.h"
 #include "sol/SpriteSelection.h"
 #include "sol/SpriteAnimation.h"
+#include "sol/Sprite.h"
 
 SpriteGraphicsView::SpriteGraphicsView (QStatusBar *statusBar) :
-    SQCGraphicsView(statusBar)
+    SQCGraphicsView(statusBar),
+    _sprite(0),
+    _picking(true)
 {
     QSettings s;
     s.beginGroup("sprite_graphics_view");
@@ -43,20 +47,46 @@ SpriteGraphicsView::SpriteGraphicsView (QStatusBar *statusBar) :
     s.endGroup();
     setScene(new QGraphicsScene());
     setMouseTracking(true);
-    _image = new QGraphicsPixmapItem;
+    _image = new TiledPixmapItem;
     scene()->addItem(_image);
+    _loading = new QGraphicsSimpleTextItem(tr("Loading..."));
+    _loading->setFlag(QGraphicsItem::ItemIgnoresTransformations);
+    _loading->setVisible(false);
+    scene()->addItem(_loading);
 }
 
 void SpriteGraphicsView::setImage (const QPixmap &image)
 {
+    _loading->setVisible(false);
     _image->setPixmap(image);
     scene()->setSceneRect(image.rect());
 }
 
+void SpriteGraphicsView::setLoading (const QSize &size)
+{
+    _image->setPixmap(QPixmap());
+    _loading->setVisible(true);
+    scene()->setSceneRect(0, 0, size.width(), size.height());
+}
+
+void SpriteGraphicsView::setSprite (const Sprite *sprite)
+{
+    _sprite = sprite;
+}
+
+void SpriteGraphicsView::setPicking (bool picking)
+{
+    _picking = picking;
+    if (!picking) {
+        viewport()->unsetCursor();
+    }
+}
+
 void SpriteGraphicsView::setSelection (
     const SpriteAnimation &animation, const SpriteSelection &selection
 ) {
     clear();
+    _animation = selection.animation();
     if (selection.haveDirection()) {
         int dir = selection.direction();
         SpriteDirection direction = animation.direction(dir);
@@ -104,3 +134,28 @@ void SpriteGraphicsView::onSelection (const Rect &selection)
     }
     emit newSelection(selection);
 }
+
+bool SpriteGraphicsView::clickOnScene (int x, int y)
+{
+    if (!_picking || _sprite == 0) {
+        return false;
+    }
+    QList<int> directions = _sprite->directionsAt(_animation, x, y);
+    if (directions.isEmpty()) {
+        return false;
+    }
+    emit directionClicked(directions.first());
+    return true;
+}
+
+void SpriteGraphicsView::hoverOnScene (int x, int y)
+{
+    if (!_picking || _sprite == 0) {
+        return;
+    }
+    if (_sprite->directionsAt(_animation, x, y).isEmpty()) {
+        viewport()->unsetCursor();
+    } else {
+        viewport()->setCursor(Qt::PointingHandCursor);
+    }
+}
@@ -0,0 +1,111 @@
+/*
+ * Solarus Quest Creator - GUI to build games for Solarus engine
+ * Copyright (C) 2013, Van den Branden Maxime <max.van.den.branden@gmail.com>
+ *
+ * Licensed under the EUPL, Version 1.1
+ * You may not use this work except in compliance with the Licence.
+ * You may obtain a copy of the Licence at:
+ *
+ * http://ec.europa.eu/idabc/eupl
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the Licence is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the Licence for the specific language governing permissions and
+ * limitations under the Licence.
+ */
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
+#include <QWidget>
+#include <qmath.h>
+#include "gui/graphics/TiledPixmapItem.h"
+
+TiledPixmapItem::TiledPixmapItem (QGraphicsItem *parent) :
+    QGraphicsItem(parent)
+{
+    setFlag(QGraphicsItem::ItemUsesExtendedStyleOption);
+}
+
+QPixmap TiledPixmapItem::pixmap () const
+{
+    return _pixmap;
+}
+
+void TiledPixmapItem::setPixmap (const QPixmap &pixmap)
+{
+    prepareGeometryChange();
+    _pixmap = pixmap;
+    _tiles.clear();
+    update();
+}
+
+QRectF TiledPixmapItem::boundingRect () const
+{
+    return QRectF(_pixmap.rect());
+}
+
+void TiledPixmapItem::paint (
+    QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget
+) {
+    if (_pixmap.isNull()) {
+        return;
+    }
+    qreal lod = option->levelOfDetailFromTransform(painter->worldTransform());
+    int level = _levelFor(lod);
+    if (widget != 0) {
+        // Une tuile réduite couvre au moins TILE_SIZE / 2 pixels de la vue.
+        int half = TILE_SIZE / 2;
+        int cols = (widget->width() + half - 1) / half + 1;
+        int rows = (widget->height() + half - 1) / half + 1;
+        _tiles.setMaxCost(cols * rows);
+    }
+    int span = TILE_SIZE << level;
+    QRectF exposed = option->exposedRect & boundingRect();
+    int tx1 = qFloor(exposed.left() / span);
+    int ty1 = qFloor(exposed.top() / span);
+    int tx2 = qCeil(exposed.right() / span);
+    int ty2 = qCeil(exposed.bottom() / span);
+    for (int ty = ty1; ty < ty2; ty++) {
+        for (int tx = tx1; tx < tx2; tx++) {
+            QRect src = QRect(tx * span, ty * span, span, span) &
+                _pixmap.rect();
+            if (level == 0) {
+                painter->drawPixmap(QRectF(src), _pixmap, QRectF(src));
+            } else {
+                QPixmap tile = _tile(level, tx, ty, src);
+                painter->drawPixmap(QRectF(src), tile, QRectF(tile.rect()));
+            }
+        }
+    }
+}
+
+int TiledPixmapItem::_levelFor (qreal levelOfDetail) const
+{
+    int w = _pixmap.width(), h = _pixmap.height();
+    int level = 0;
+    qreal scale = 1.0;
+    while (
+        levelOfDetail <= scale / 2 &&
+        (w >> (level + 1)) > 0 && (h >> (level + 1)) > 0
+    ) {
+        level++;
+        scale /= 2;
+    }
+    return level;
+}
+
+QPixmap TiledPixmapItem::_tile (
+    int level, int tx, int ty, const QRect &source
+) {
+    quint64 key = ((quint64)level << 56) | ((quint64)ty << 28) | tx;
+    QPixmap *cached = _tiles.object(key);
+    if (cached != 0) {
+        return *cached;
+    }
+    QPixmap tile = _pixmap.copy(source).scaled(
+        qMax(source.width() >> level, 1), qMax(source.height() >> level, 1),
+        Qt::IgnoreAspectRatio, Qt::SmoothTransformation
+    );
+    _tiles.insert(key, new QPixmap(tile));
+    return tile;
+}
@@ -0,0 +1,109 @@
+/*
+ * Solarus Quest Creator - GUI to build games for Solarus engine
+ * Copyright (C) 2013, Van den Branden Maxime <max.van.den.branden@gmail.com>
+ *
+ * Licensed under the EUPL, Version 1.1
+ * You may not use this work except in compliance with the Licence.
+ * You may obtain a copy of the Licence at:
+ *
+ * http://ec.europa.eu/idabc/eupl
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the Licence is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the Licence for the specific language governing permissions and
+ * limitations under the Licence.
+ */
+#include "gui/graphics/TilesetGraphicsView.h"
+#include "gui/graphics/TiledPixmapItem.h"
+#include "sol/Tileset.h"
+
+TilesetGraphicsView::TilesetGraphicsView (QStatusBar *statusBar) :
+    SQCGraphicsView(statusBar),
+    _tileset(0)
+{
+    _showSceneBorder = true;
+    setBackgroundBrush(QColor("#c0c0c0"));
+    setScene(new QGraphicsScene());
+    setMouseTracking(true);
+    setMakeSelection(true);
+    _image = new TiledPixmapItem;
+    scene()->addItem(_image);
+}
+
+void TilesetGraphicsView::setImage (const QPixmap &image)
+{
+    _image->setPixmap(image);
+    scene()->setSceneRect(image.rect());
+}
+
+void TilesetGraphicsView::setTileset (const Tileset *tileset)
+{
+    _tileset = tileset;
+    if (!_image->pixmap().isNull() || _tileset == 0) {
+        return;
+    }
+    QRect bounds;
+    QList<TilePattern> patterns = _tileset->allPatterns();
+    for (int i = 0; i < patterns.size(); i++) {
+        QList<Rect> frames = patterns[i].frames();
+        for (int j = 0; j < frames.size(); j++) {
+            bounds |= QRect(
+                frames[j].x, frames[j].y, frames[j].width, frames[j].height
+            );
+        }
+    }
+    scene()->setSceneRect(0, 0, bounds.right() + 1, bounds.bottom() + 1);
+}
+
+void TilesetGraphicsView::setSelection (const QList<int> &selection)
+{
+    clear();
+    if (_tileset != 0) {
+        QList<TilePattern> patterns = _tileset->patterns(selection);
+        for (int i = 0; i < patterns.size(); i++) {
+            QList<Rect> frames = patterns[i].frames();
+            for (int j = 0; j < frames.size(); j++) {
+                addToSelection((ComplexSelection){frames[j], 1, 1});
+            }
+        }
+        if (!patterns.isEmpty()) {
+            const TilePattern &first = patterns.first();
+            ensureVisible(first.x(), first.y(), first.width(), first.height());
+        }
+    }
+    viewport()->update();
+}
+
+void TilesetGraphicsView::onSelection (const Rect &selection)
+{
+    if (_tileset == 0) {
+        return;
+    }
+    emit patternsSelected(_tileset->patternsIn(selection));
+}
+
+bool TilesetGraphicsView::clickOnScene (int x, int y)
+{
+    if (_tileset == 0) {
+        return false;
+    }
+    QList<int> patterns = _tileset->patternsAt(x, y);
+    if (patterns.isEmpty()) {
+        return false;
+    }
+    emit patternClicked(patterns.first());
+    return true;
+}
+
+void TilesetGraphicsView::hoverOnScene (int x, int y)
+{
+    if (_tileset == 0) {
+        return;
+    }
+    if (_tileset->patternsAt(x, y).isEmpty()) {
+        viewport()->unsetCursor();
+    } else {
+        viewport()->setCursor(Qt::PointingHandCursor);
+    }
+}
@@ -0,0 +1,435 @@
+/*
+ * Solarus Quest Creator - GUI to build games for Solarus engine
+ * Copyright (C) 2013, Van den Branden Maxime <max.van.den.branden@gmail.com>
+ *
+ * Licensed under the EUPL, Version 1.1
+ * You may not use this work except in compliance with the Licence.
+ * You may obtain a copy of the Licence at:
+ *
+ * http://ec.europa.eu/idabc/eupl
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the Licence is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the Licence for the specific language governing permissions and
+ * limitations under the Licence.
+ */
+#include <QFont>
+#include <QIcon>
+#include <QPixmapCache>
+#include "gui/model/QuestTreeModel.h"
+#include "sol/Quest.h"
+
+QuestTreeModel::QuestTreeModel (QObject *parent) :
+    QAbstractItemModel(parent),
+    _current(0)
+{
+    for (int type = MAP; type < N_RESOURCE_TYPE; ++type) {
+        _types.push_back((ResourceType)type);
+    }
+}
+
+QuestTreeModel::~QuestTreeModel ()
+{
+    for (int i = 0; i < _nodes.size(); ++i) {
+        delete _nodes[i];
+    }
+}
+
+void QuestTreeModel::addQuest (Quest *quest)
+{
+    beginInsertRows(QModelIndex(), _nodes.size(), _nodes.size());
+    _nodes.push_back(new QuestNode(this, quest));
+    endInsertRows();
+}
+
+void QuestTreeModel::setCurrentQuest (Quest *quest)
+{
+    Quest *previous = _current;
+    _current = quest;
+    for (int i = 0; i < _nodes.size(); ++i) {
+        if (_nodes[i]->quest == previous || _nodes[i]->quest == quest) {
+            QModelIndex index = _questIndex(_nodes[i]);
+            emit dataChanged(index, index);
+        }
+    }
+}
+
+Quest *QuestTreeModel::quest (const QModelIndex &index) const
+{
+    if (!index.isValid()) {
+        return 0;
+    }
+    Node *node = (Node *)index.internalPointer();
+    if (node == 0) {
+        return _nodes[index.row()]->quest;
+    }
+    if (node->isFolder) {
+        return ((Folder *)node)->node->quest;
+    }
+    return ((QuestNode *)node)->quest;
+}
+
+bool QuestTreeModel::isResource (const QModelIndex &index) const
+{
+    return _resourceFolder(index) != 0;
+}
+
+ResourceType QuestTreeModel::resourceType (const QModelIndex &index) const
+{
+    Folder *folder = _resourceFolder(index);
+    if (folder == 0) {
+        return N_RESOURCE_TYPE;
+    }
+    return folder->type;
+}
+
+QString QuestTreeModel::resourceId (const QModelIndex &index) const
+{
+    Folder *folder = _resourceFolder(index);
+    if (folder == 0) {
+        return "";
+    }
+    return folder->ids[index.row()];
+}
+
+QModelIndex QuestTreeModel::index (
+    int row, int column, const QModelIndex &parent
+) const {
+    if (row < 0 || column != 0) {
+        return QModelIndex();
+    }
+    if (!parent.isValid()) {
+        if (row >= _nodes.size()) {
+            return QModelIndex();
+        }
+        return createIndex(row, 0, (void *)0);
+    }
+    QuestNode *node = _questNode(parent);
+    if (node != 0) {
+        if (row >= node->folders.size()) {
+            return QModelIndex();
+        }
+        return createIndex(row, 0, (Node *)node);
+    }
+    Folder *folder = _folderNode(parent);
+    if (folder != 0 && row < folder->ids.size()) {
+        return createIndex(row, 0, (Node *)folder);
+    }
+    return QModelIndex();
+}
+
+QModelIndex QuestTreeModel::parent (const QModelIndex &index) const
+{
+    if (!index.isValid()) {
+        return QModelIndex();
+    }
+    Node *node = (Node *)index.internalPointer();
+    if (node == 0) {
+        return QModelIndex();
+    }
+    if (node->isFolder) {
+        return _folderIndex((Folder *)node);
+    }
+    return _questIndex((QuestNode *)node);
+}
+
+int QuestTreeModel::rowCount (const QModelIndex &parent) const
+{
+    if (!parent.isValid()) {
+        return _nodes.size();
+    }
+    if (parent.column() != 0) {
+        return 0;
+    }
+    QuestNode *node = _questNode(parent);
+    if (node != 0) {
+        return node->folders.size();
+    }
+    Folder *folder = _folderNode(parent);
+    if (folder != 0) {
+        return folder->ids.size();
+    }
+    return 0;
+}
+
+int QuestTreeModel::columnCount (const QModelIndex &) const
+{
+    return 1;
+}
+
+bool QuestTreeModel::hasChildren (const QModelIndex &parent) const
+{
+    Folder *folder = _folderNode(parent);
+    if (folder != 0 && !folder->fetched) {
+        return !folder->node->quest->resourceNames(folder->type).isEmpty();
+    }
+    return rowCount(parent) > 0;
+}
+
+bool QuestTreeModel::canFetchMore (const QModelIndex &parent) const
+{
+    Folder *folder = _folderNode(parent);
+    return folder != 0 && !folder->fetched;
+}
+
+void QuestTreeModel::fetchMore (const QModelIndex &parent)
+{
+    Folder *folder = _folderNode(parent);
+    if (folder == 0 || folder->fetched) {
+        return;
+    }
+    QStringList ids = folder->node->quest->resourceIds(folder->type);
+    if (ids.isEmpty()) {
+        folder->fetched = true;
+        return;
+    }
+    beginInsertRows(parent, 0, ids.size() - 1);
+    folder->ids = ids;
+    folder->fetched = true;
+    endInsertRows();
+}
+
+QVariant QuestTreeModel::data (const QModelIndex &index, int role) const
+{
+    if (!index.isValid()) {
+        return QVariant();
+    }
+    Node *node = (Node *)index.internalPointer();
+    if (node == 0) {
+        return _questData(_nodes[index.row()], role);
+    }
+    if (node->isFolder) {
+        Folder *folder = (Folder *)node;
+        return _resourceData(folder, folder->ids[index.row()], role);
+    }
+    return _folderData(((QuestNode *)node)->folders[index.row()], role);
+}
+
+QModelIndex QuestTreeModel::_questIndex (QuestNode *node) const
+{
+    return createIndex(_nodes.indexOf(node), 0, (void *)0);
+}
+
+QModelIndex QuestTreeModel::_folderIndex (Folder *folder) const
+{
+    return createIndex(folder->row, 0, (Node *)folder->node);
+}
+
+QuestTreeModel::QuestNode *QuestTreeModel::_questNode (
+    const QModelIndex &index
+) const {
+    if (!index.isValid() || index.internalPointer() != 0) {
+        return 0;
+    }
+    return _nodes[index.row()];
+}
+
+QuestTreeModel::Folder *QuestTreeModel::_folderNode (
+    const QModelIndex &index
+) const {
+    if (!index.isValid()) {
+        return 0;
+    }
+    Node *node = (Node *)index.internalPointer();
+    if (node == 0 || node->isFolder) {
+        return 0;
+    }
+    return ((QuestNode *)node)->folders[index.row()];
+}
+
+QuestTreeModel::Folder *QuestTreeModel::_resourceFolder (
+    const QModelIndex &index
+) const {
+    if (!index.isValid()) {
+        return 0;
+    }
+    Node *node = (Node *)index.internalPointer();
+    if (node == 0 || !node->isFolder) {
+        return 0;
+    }
+    return (Folder *)node;
+}
+
+QVariant QuestTreeModel::_questData (QuestNode *node, int role) const
+{
+    if (role == Qt::DisplayRole) {
+        QString title = node->quest->titleBar();
+        if (node->loaded < node->total) {
+            title += QString(" (%1/%2)").arg(node->loaded).arg(node->total);
+        }
+        return title;
+    } else if (role == Qt::DecorationRole) {
+        return QIcon(":fugue/box");
+    } else if (role == Qt::FontRole && node->quest == _current) {
+        QFont font;
+        font.setBold(true);
+        return font;
+    }
+    return QVariant();
+}
+
+QVariant QuestTreeModel::_folderData (Folder *folder, int role) const
+{
+    if (role == Qt::DisplayRole) {
+        return _typeName(folder->type);
+    } else if (role == Qt::DecorationRole) {
+        return QIcon(":fugue/dir");
+    }
+    return QVariant();
+}
+
+QVariant QuestTreeModel::_resourceData (
+    Folder *folder, QString id, int role
+) const {
+    Quest *quest = folder->node->quest;
+    if (role == Qt::DisplayRole) {
+        return quest->resourceName(folder->type, id);
+    } else if (role == Qt::DecorationRole) {
+        QImage thumbnail = quest->thumbnail(folder->type, id);
+        if (thumbnail.isNull()) {
+            return QIcon(":fugue/file");
+        }
+        QString key = QString("sqc_thumbnail_%1").arg(thumbnail.cacheKey());
+        QPixmap pixmap;
+        if (!QPixmapCache::find(key, &pixmap)) {
+            pixmap = QPixmap::fromImage(thumbnail);
+            QPixmapCache::insert(key, pixmap);
+        }
+        return QIcon(pixmap);
+    }
+    return QVariant();
+}
+
+QString QuestTreeModel::_typeName (ResourceType type) const
+{
+    switch (type) {
+    case MAP: return tr("Map");
+    case TILESET: return tr("Tileset");
+    case MUSIC: return tr("Music");
+    case SPRITE: return tr("Sprite");
+    case SOUND: return tr("Sound");
+    case ITEM: return tr("Item");
+    case ENEMY: return tr("Enemy");
+    case LANGUAGE: return tr("Language");
+    default: return "";
+    }
+}
+
+QuestTreeModel::QuestNode::QuestNode (QuestTreeModel *model, Quest *quest) :
+    model(model),
+    quest(quest),
+    loaded(0),
+    total(0)
+{
+    isFolder = false;
+    for (int i = 0; i < model->_types.size(); ++i) {
+        Folder *folder = new Folder;
+        folder->isFolder = true;
+        folder->node = this;
+        folder->type = model->_types[i];
+        folder->row = i;
+        folder->fetched = false;
+        folders.push_back(folder);
+    }
+    quest->attach(this);
+}
+
+QuestTreeModel::QuestNode::~QuestNode ()
+{
+    for (int i = 0; i < folders.size(); ++i) {
+        delete folders[i];
+    }
+}
+
+void QuestTreeModel::QuestNode::refreshResource (
+    ResourceType type, QString id
+) {
+    _refresh(type, id);
+}
+
+void QuestTreeModel::QuestNode::addResource (ResourceType type, QString id)
+{
+    Folder *folder = _folder(type);
+    if (folder == 0) {
+        return;
+    }
+    QModelIndex parent = model->_folderIndex(folder);
+    if (!folder->fetched) {
+        if (quest->resourceNames(type).size() == 1) {
+            model->fetchMore(parent);
+        }
+        return;
+    }
+    QStringList::Iterator it = qLowerBound(
+        folder->ids.begin(), folder->ids.end(), id
+    );
+    int row = it - folder->ids.begin();
+    if (row < folder->ids.size() && folder->ids[row] == id) {
+        return;
+    }
+    model->beginInsertRows(parent, row, row);
+    folder->ids.insert(row, id);
+    model->endInsertRows();
+}
+
+void QuestTreeModel::QuestNode::removeResource (ResourceType type, QString id)
+{
+    Folder *folder = _folder(type);
+    if (folder == 0 || !folder->fetched) {
+        return;
+    }
+    QStringList::Iterator it = qBinaryFind(
+        folder->ids.begin(), folder->ids.end(), id
+    );
+    if (it == folder->ids.end()) {
+        return;
+    }
+    int row = it - folder->ids.begin();
+    model->beginRemoveRows(model->_folderIndex(folder), row, row);
+    folder->ids.removeAt(row);
+    model->endRemoveRows();
+}
+
+void QuestTreeModel::QuestNode::refreshPreload (int loaded, int total)
+{
+    this->loaded = loaded;
+    this->total = total;
+    QModelIndex index = model->_questIndex(this);
+    emit model->dataChanged(index, index);
+}
+
+void QuestTreeModel::QuestNode::refreshThumbnail (
+    ResourceType type, QString id
+) {
+    _refresh(type, id);
+}
+
+QuestTreeModel::Folder *QuestTreeModel::QuestNode::_folder (
+    ResourceType type
+) const {
+    for (int i = 0; i < folders.size(); ++i) {
+        if (folders[i]->type == type) {
+            return folders[i];
+        }
+    }
+    return 0;
+}
+
+void QuestTreeModel::QuestNode::_refresh (ResourceType type, QString id)
+{
+    Folder *folder = _folder(type);
+    if (folder == 0 || !folder->fetched) {
+        return;
+    }
+    QStringList::Iterator it = qBinaryFind(
+        folder->ids.begin(), folder->ids.end(), id
+    );
+    if (it == folder->ids.end()) {
+        return;
+    }
+    QModelIndex index = model->index(
+        it - folder->ids.begin(), 0, model->_folderIndex(folder)
+    );
+    emit model->dataChanged(index, index);
+}
@@ -26,32 +26,54 @@
 #include "gui/widget/ColorButton.h"
 
 SpriteDirectionPreview::SpriteDirectionPreview () :
+    _frameItem(0),
     _currentFrame(0),
     _inPlaying(false),
+    _controlsPlaying(true),
     _frameDelay(0),
-    _frameOnLoop(-1)
+    _frameOnLoop(-1),
+    _clockFrame(0)
 {
+    _timer.setSingleShot(true);
+    _timer.setTimerType(Qt::PreciseTimer);
     _initWidgets();
     _connects();
 }
 
 void SpriteDirectionPreview::setImage (const QPixmap &pix)
 {
-    _pix = pix;
+    if (pix.cacheKey() != _pix.cacheKey()) {
+        _pix = pix;
+        _sliceFrames();
+    }
     _refreshView();
 }
 
 void SpriteDirectionPreview::setDirection (const SpriteDirection &direction)
 {
-    _direction = direction;
+    if (_direction != direction) {
+        _direction = direction;
+        _sliceFrames();
+    }
     _currentFrame = 0;
+    if (_inPlaying) {
+        _startClock();
+    }
     _refreshView();
 }
 
 void SpriteDirectionPreview::setFrameDelay (const int &frameDelay)
 {
     _frameDelay = frameDelay;
-    _timer.setInterval(frameDelay);
+    if (_inPlaying) {
+        if (frameDelay > 0) {
+            _startClock();
+        } else {
+            _timer.stop();
+            _inPlaying = false;
+            _refreshControls();
+        }
+    }
 }
 
 void SpriteDirectionPreview::setFrameOnLoop (const int &frameOnLoop)
@@ -70,13 +92,29 @@ void SpriteDirectionPreview::changeEvent (QEvent *event)
         _timer.stop();
         _inPlaying = false;
         _currentFrame = 0;
-        _graphicsView->scene()->clear();
+        _frameItem->setVisible(false);
     }
 }
 
+void SpriteDirectionPreview::showEvent (QShowEvent *event)
+{
+    QWidget::showEvent(event);
+    if (_inPlaying) {
+        _step();
+    }
+}
+
+void SpriteDirectionPreview::hideEvent (QHideEvent *event)
+{
+    QWidget::hideEvent(event);
+    _timer.stop();
+}
+
 void SpriteDirectionPreview::_initWidgets ()
 {
     _graphicsView = new SpriteDirectionGraphicsView;
+    _frameItem = new QGraphicsPixmapItem;
+    _graphicsView->scene()->addItem(_frameItem);
     _frame = new QLabel;
     _play = new QPushButton(QIcon(":media/play"), "");
     _next = new QPushButton(QIcon(":media/next"), "");
@@ -160,18 +198,53 @@ void SpriteDirectionPreview::_connects ()
     );
 }
 
+void SpriteDirectionPreview::_sliceFrames ()
+{
+    _frames.clear();
+    int x = _direction.x(), y = _direction.y();
+    int w = _direction.width(), h = _direction.height();
+    int nbColumns = _direction.nbColumns();
+    for (int i = 0; i < _direction.nbFrames(); i++) {
+        int col = i % nbColumns;
+        int row = i / nbColumns;
+        _frames.push_back(_pix.copy(x + col * w, y + row * h, w, h));
+    }
+    _graphicsView->scene()->setSceneRect(0, 0, w, h);
+    _graphicsView->setOrigin(_direction.originX(), _direction.originY());
+}
+
 void SpriteDirectionPreview::_refreshView ()
 {
-    int nbFrames = _direction.nbFrames();
+    _refreshFrame();
+    _refreshControls();
+}
+
+void SpriteDirectionPreview::_refreshFrame ()
+{
+    int nbFrames = _frames.size();
     _frame->setText(
         QString::number(_currentFrame) + "/" + QString::number(nbFrames - 1)
     );
-    if (_inPlaying) {
-        _play->setIcon(QIcon(":media/pause"));
-        _play->setToolTip(tr("Pause"));
+    if (_currentFrame >= 0 && _currentFrame < nbFrames) {
+        _frameItem->setPixmap(_frames[_currentFrame]);
+        _frameItem->setVisible(true);
     } else {
-        _play->setIcon(QIcon(":media/play"));
-        _play->setToolTip(tr("Play"));
+        _frameItem->setVisible(false);
+    }
+}
+
+void SpriteDirectionPreview::_refreshControls ()
+{
+    int nbFrames = _frames.size();
+    if (_inPlaying != _controlsPlaying) {
+        _controlsPlaying = _inPlaying;
+        if (_inPlaying) {
+            _play->setIcon(QIcon(":media/pause"));
+            _play->setToolTip(tr("Pause"));
+        } else {
+            _play->setIcon(QIcon(":media/play"));
+            _play->setToolTip(tr("Play"));
+        }
     }
     _play->setEnabled(nbFrames > 1 && _frameDelay > 0);
     _stop->setEnabled(_inPlaying);
@@ -179,17 +252,15 @@ void SpriteDirectionPreview::_refreshView ()
     _first->setEnabled(!_inPlaying && _currentFrame > 0);
     _next->setEnabled(!_inPlaying && _currentFrame < nbFrames - 1);
     _last->setEnabled(!_inPlaying && _currentFrame < nbFrames - 1);
-    int x = _direction.x(), y = _direction.y();
-    int w = _direction.width(), h = _direction.height();
-    int col = _currentFrame % _direction.nbColumns();
-    int row = _currentFrame / _direction.nbColumns();
-    _graphicsView->scene()->clear();
-    x += col * w;
-    y += row * h;
-    QPixmap pix = _pix.copy(x, y, w, h);
-    _graphicsView->scene()->addItem(new QGraphicsPixmapItem(pix));
-    _graphicsView->scene()->setSceneRect(pix.rect());
-    _graphicsView->setOrigin(_direction.originX(), _direction.originY());
+}
+
+void SpriteDirectionPreview::_startClock ()
+{
+    _clockFrame = _currentFrame;
+    _clock.start();
+    if (isVisible()) {
+        _timer.start(_frameDelay);
+    }
 }
 
 void SpriteDirectionPreview::_playAction ()
@@ -198,8 +269,8 @@ void SpriteDirectionPreview::_playAction ()
         _timer.stop();
         _inPlaying = false;
     } else if (_frameDelay > 0) {
-        _timer.start();
         _inPlaying = true;
+        _startClock();
     }
     _refreshView();
 }
@@ -238,17 +309,31 @@ void SpriteDirectionPreview::_firstAction ()
 
 void SpriteDirectionPreview::_step ()
 {
-    _currentFrame++;
-    if (_currentFrame >= _direction.nbFrames()) {
-        if (_frameOnLoop >= 0) {
-            _currentFrame = _frameOnLoop;
+    if (!_inPlaying || _frameDelay <= 0) {
+        return;
+    }
+    int nbFrames = _direction.nbFrames();
+    qint64 elapsed = _clock.elapsed();
+    qint64 frame = _clockFrame + elapsed / _frameDelay;
+    if (frame >= nbFrames) {
+        if (_frameOnLoop >= 0 && _frameOnLoop < nbFrames) {
+            int loopLength = nbFrames - _frameOnLoop;
+            frame = _frameOnLoop + (frame - nbFrames) % loopLength;
         } else {
             _timer.stop();
             _inPlaying = false;
-            _currentFrame = _direction.nbFrames() - 1;
+            _currentFrame = nbFrames - 1;
+            _refreshView();
+            return;
         }
     }
-    _refreshView();
+    if (frame != _currentFrame) {
+        _currentFrame = frame;
+        _refreshFrame();
+    }
+    if (isVisible()) {
+        _timer.start(_frameDelay - elapsed % _frameDelay);
+    }
 }
 
 void SpriteDirectionPreview::_refreshShowOrigin (bool show, bool cross)
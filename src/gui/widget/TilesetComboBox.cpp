@@ -52,3 +52,9 @@ void TilesetComboBox::removeResource (ResourceType type, QString id)
         removeItem(findData(id));
     }
 }
+
+void TilesetComboBox::refreshPreload (int, int)
+{}
+
+void TilesetComboBox::refreshThumbnail (ResourceType, QString)
+{}
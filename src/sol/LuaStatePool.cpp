@@ -0,0 +1,125 @@
+/*
+ * Solarus Quest Creator - GUI to build games for Solarus engine
+ * Copyright (C) 2013, Van den Branden Maxime <max.van.den.branden@gmail.com>
+ *
+ * Licensed under the EUPL, Version 1.1
+ * You may not use this work except in compliance with the Licence.
+ * You may obtain a copy of the Licence at:
+ *
+ * http://ec.europa.eu/idabc/eupl
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the Licence is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the Licence for the specific language governing permissions and
+ * limitations under the Licence.
+ */
+#include <QObject>
+#include <QThread>
+#include "sol/LuaStatePool.h"
+#include "sol/Quest.h"
+#include "sol/Tileset.h"
+
+QMutex LuaStatePool::_mutex;
+QList<lua_State *> LuaStatePool::_states;
+int LuaStatePool::_maxStates = QThread::idealThreadCount() + 1;
+
+LuaStatePool::Lease::Lease () :
+    _L(LuaStatePool::_acquire()),
+    _running(false)
+{}
+
+LuaStatePool::Lease::~Lease ()
+{
+    if (_running) {
+        lua_close(_L);
+        return;
+    }
+    for (int i = 0; i < _keys.size(); ++i) {
+        lua_pushnil(_L);
+        lua_setfield(_L, LUA_REGISTRYINDEX, _keys[i]);
+    }
+    lua_settop(_L, 0);
+    LuaStatePool::_release(_L);
+}
+
+lua_State *LuaStatePool::Lease::state () const
+{
+    return _L;
+}
+
+void LuaStatePool::Lease::setUserData (const char *key, void *pointer)
+{
+    lua_pushlightuserdata(_L, pointer);
+    lua_setfield(_L, LUA_REGISTRYINDEX, key);
+    _keys.push_back(key);
+}
+
+void LuaStatePool::Lease::run (QString filename) throw(SQCException)
+{
+    if (luaL_loadfile(_L, filename.toStdString().c_str())) {
+        lua_settop(_L, 0);
+        throw SQCException(QObject::tr("lua load error"));
+    }
+    lua_newtable(_L);
+    lua_newtable(_L);
+    lua_pushvalue(_L, LUA_GLOBALSINDEX);
+    lua_setfield(_L, -2, "__index");
+    lua_setmetatable(_L, -2);
+    lua_setfenv(_L, -2);
+    _running = true;
+    int error = lua_pcall(_L, 0, 0, 0);
+    _running = false;
+    if (error != 0) {
+        lua_settop(_L, 0);
+        throw SQCException(QObject::tr("lua call error"));
+    }
+}
+
+void LuaStatePool::setMaxStates (int max)
+{
+    QMutexLocker locker(&_mutex);
+    _maxStates = max;
+    while (_states.size() > _maxStates) {
+        lua_close(_states.takeLast());
+    }
+}
+
+void LuaStatePool::clear ()
+{
+    QMutexLocker locker(&_mutex);
+    for (int i = 0; i < _states.size(); ++i) {
+        lua_close(_states[i]);
+    }
+    _states.clear();
+}
+
+lua_State *LuaStatePool::_acquire ()
+{
+    _mutex.lock();
+    if (!_states.isEmpty()) {
+        lua_State *L = _states.takeLast();
+        _mutex.unlock();
+        return L;
+    }
+    _mutex.unlock();
+    return _newState();
+}
+
+void LuaStatePool::_release (lua_State *L)
+{
+    QMutexLocker locker(&_mutex);
+    if (_states.size() < _maxStates) {
+        _states.push_back(L);
+    } else {
+        lua_close(L);
+    }
+}
+
+lua_State *LuaStatePool::_newState ()
+{
+    lua_State *L = luaL_newstate();
+    lua_register(L, "quest", Quest::_lua_quest);
+    Tileset::_luaRegister(L);
+    return L;
+}
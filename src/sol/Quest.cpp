@@ -24,9 +24,13 @@
 #include "sol/Tileset.h"
 #include "sol/Sprite.h"
 #include "sol/TilePattern.h"
+#include "sol/ResourceLoader.h"
+#include "sol/ThumbnailCache.h"
+#include "sol/LuaStatePool.h"
+#include "sol/ResourceCache.h"
 #include "util/FileTools.h"
 
-Quest *Quest::load (QString directory) throw(QuestException)
+Quest *Quest::load (QString directory, bool preload) throw(QuestException)
 {
     directory = FileTools::absolutePath(directory);
     Quest *quest = new Quest(directory);
@@ -38,6 +42,9 @@ Quest *Quest::load (QString directory) throw(QuestException)
             QObject::tr("cannot load the quest, ") + ex.message()
         );
     }
+    if (preload) {
+        quest->preload();
+    }
     return quest;
 }
 
@@ -49,6 +56,8 @@ void Quest::save () throw (SQCException)
 
 Quest::~Quest ()
 {
+    delete _loader;
+    delete _thumbnails;
     for (int type = MAP; type < N_RESOURCE_TYPE; ++type) {
         QMap<QString, Resource *>::Iterator it = _resources[type].begin();
         for (; it != _resources[type].end(); ++it) {
@@ -79,7 +88,9 @@ QString Quest::titleBar () const
 
 Quest::Quest (QString directory) throw(QuestException) :
     _directory(directory),
-    _dataDirectory(directory + "data/")
+    _dataDirectory(directory + "data/"),
+    _loader(0),
+    _thumbnails(0)
 {}
 
 bool Quest::resourceExists (ResourceType type, QString id) const
@@ -101,9 +112,17 @@ Tileset Quest::tileset (QString id) throw(QuestException)
 {
     if (!_resources[TILESET].contains(id)) {
         if (_resourceNames[TILESET].contains(id)) {
-            _resources[TILESET][id] = Tileset::load(
-                _dataDirectory, id, _resourceNames[TILESET][id]
-            );
+            Resource *resource = _takePreloaded(TILESET, id);
+            if (resource == 0) {
+                try {
+                    resource = ResourceCache::load(
+                        _directory, TILESET, id, _resourceNames[TILESET][id]
+                    );
+                } catch (const SQCException &ex) {
+                    throw QuestException(ex.message());
+                }
+            }
+            _resources[TILESET][id] = resource;
         } else {
             QString msg = QObject::tr("tileset $1 does not exists");
             msg.replace("$1", id);
@@ -117,9 +136,17 @@ Sprite Quest::sprite (QString id) throw(QuestException)
 {
     if (!_resources[SPRITE].contains(id)) {
         if (_resourceNames[SPRITE].contains(id)) {
-            _resources[SPRITE][id] = Sprite::load(
-                _dataDirectory, id, _resourceNames[SPRITE][id]
-            );
+            Resource *resource = _takePreloaded(SPRITE, id);
+            if (resource == 0) {
+                try {
+                    resource = ResourceCache::load(
+                        _directory, SPRITE, id, _resourceNames[SPRITE][id]
+                    );
+                } catch (const SQCException &ex) {
+                    throw QuestException(ex.message());
+                }
+            }
+            _resources[SPRITE][id] = resource;
         } else {
             QString msg = QObject::tr("sprite $1 does not exists");
             msg.replace("$1", id);
@@ -179,6 +206,9 @@ bool Quest::removeResource (ResourceType type, QString id)
     delete _resources[type][id];
     _resources[type].remove(id);
     _resourceNames[type].remove(id);
+    if (_thumbnails != 0) {
+        _thumbnails->invalidate(type, id);
+    }
     for (int i = 0; i < _views.size(); ++i) {
         _views[i]->removeResource(type, id);
     }
@@ -195,6 +225,50 @@ bool Quest::removeSprite (QString id)
     return removeResource(SPRITE, id);
 }
 
+void Quest::preload ()
+{
+    if (_loader == 0) {
+        _loader = new ResourceLoader(this);
+    }
+    ResourceType types[] = {TILESET, SPRITE};
+    for (int i = 0; i < 2; ++i) {
+        QMap<QString, QString>::Iterator it = _resourceNames[types[i]].begin();
+        for (; it != _resourceNames[types[i]].end(); ++it) {
+            if (!_resources[types[i]].contains(it.key())) {
+                _loader->load(types[i], it.key(), it.value());
+            }
+        }
+    }
+}
+
+bool Quest::isPreloading () const
+{
+    return _loader != 0 && _loader->loaded() < _loader->total();
+}
+
+QImage Quest::thumbnail (ResourceType type, QString id)
+{
+    if (_thumbnails == 0) {
+        _thumbnails = new ThumbnailCache(this, _thumbnailTileset);
+    }
+    return _thumbnails->thumbnail(type, id);
+}
+
+void Quest::setThumbnailTileset (QString tileset)
+{
+    if (tileset == _thumbnailTileset) {
+        return;
+    }
+    _thumbnailTileset = tileset;
+    if (_thumbnails != 0) {
+        _thumbnails->setTileset(tileset);
+        QList<QString> ids = _resourceNames[SPRITE].keys();
+        for (int i = 0; i < ids.size(); ++i) {
+            _notifyThumbnail(SPRITE, ids[i]);
+        }
+    }
+}
+
 void Quest::attach (QuestView *view)
 {
     if (!_views.contains(view)) {
@@ -212,18 +286,13 @@ void Quest::detach (QuestView *view)
 
 void Quest::_loadQuestDat () throw(QuestException)
 {
-    lua_State *L = luaL_newstate();
-    lua_register(L, "quest", _lua_quest);
-    lua_pushlightuserdata(L, this);
-    lua_setfield(L, LUA_REGISTRYINDEX, "quest");
-    QString filename = _dataDirectory + "quest.dat";
-    if (luaL_loadfile(L, filename.toStdString().c_str())) {
-        throw QuestException(QObject::tr("lua load error"));
-    }
-    if (lua_pcall(L, 0, 0, 0) != 0) {
-        throw QuestException(QObject::tr("lua call error"));
+    LuaStatePool::Lease lua;
+    lua.setUserData("quest", this);
+    try {
+        lua.run(_dataDirectory + "quest.dat");
+    } catch (const SQCException &ex) {
+        throw QuestException(ex.message());
     }
-    lua_close(L);
 }
 
 void Quest::_loadProjectDB () throw(IOException)
@@ -286,8 +355,14 @@ void Quest::_saveProjectDB () throw(IOException)
 void Quest::_setResource (ResourceType type, QString id, Resource *resource)
 {
     bool exists = _resourceNames[type].contains(id);
+    if (_resources[type].contains(id)) {
+        delete _resources[type][id];
+    }
     _resources[type][id] = resource;
     _resourceNames[type][id] = resource->name();
+    if (_thumbnails != 0) {
+        _thumbnails->invalidate(type, id);
+    }
     for (int i = 0; i < _views.size(); ++i) {
         if (exists) {
             _views[i]->refreshResource(type, id);
@@ -297,11 +372,45 @@ void Quest::_setResource (ResourceType type, QString id, Resource *resource)
     }
 }
 
+Resource *Quest::_takePreloaded (ResourceType type, QString id)
+{
+    if (_loader == 0) {
+        return 0;
+    }
+    return _loader->take(type, id);
+}
+
+void Quest::_addPreloaded (ResourceType type, QString id, Resource *resource)
+{
+    if (_resources[type].contains(id) || !_resourceNames[type].contains(id)) {
+        delete resource;
+    } else if (resource != 0) {
+        _resources[type][id] = resource;
+    }
+}
+
+void Quest::_notifyPreload (int loaded, int total)
+{
+    for (int i = 0; i < _views.size(); ++i) {
+        _views[i]->refreshPreload(loaded, total);
+    }
+}
+
+void Quest::_notifyThumbnail (ResourceType type, QString id)
+{
+    for (int i = 0; i < _views.size(); ++i) {
+        _views[i]->refreshThumbnail(type, id);
+    }
+}
+
 int Quest::_lua_quest (lua_State *L)
 {
     lua_getfield(L, LUA_REGISTRYINDEX, "quest");
     Quest* quest = (Quest*)lua_touserdata(L, -1);
     lua_pop(L, 1);
+    if (quest == 0) {
+        return luaL_error(L, "quest is not available in this file");
+    }
 
     lua_settop(L, 1);
     lua_pushnil(L);
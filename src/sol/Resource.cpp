@@ -24,6 +24,9 @@ Resource::Resource (ResourceType type, QString id, QString name) :
     _name(name)
 {}
 
+Resource::~Resource ()
+{}
+
 ResourceType Resource::type () const
 {
     return _type;
@@ -0,0 +1,282 @@
+/*
+ * Solarus Quest Creator - GUI to build games for Solarus engine
+ * Copyright (C) 2013, Van den Branden Maxime <max.van.den.branden@gmail.com>
+ *
+ * Licensed under the EUPL, Version 1.1
+ * You may not use this work except in compliance with the Licence.
+ * You may obtain a copy of the Licence at:
+ *
+ * http://ec.europa.eu/idabc/eupl
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the Licence is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the Licence for the specific language governing permissions and
+ * limitations under the Licence.
+ */
+#include <QFile>
+#include <QSaveFile>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QUrl>
+#include "sol/ResourceCache.h"
+#include "sol/Sprite.h"
+#include "sol/Tileset.h"
+
+#define CACHE_MAGIC 0x53514352
+#define CACHE_VERSION 1
+
+Resource *ResourceCache::load (
+    QString directory, ResourceType type, QString id, QString name
+) throw(SQCException) {
+    if (type != SPRITE && type != TILESET) {
+        return 0;
+    }
+    QString dataDirectory = directory + "data/";
+    QString source = _source(type, id);
+    QString file = _file(directory, type, id);
+    QFileInfo info(dataDirectory + source);
+    if (info.exists()) {
+        Resource *resource = _read(file, source, info, type, id, name);
+        if (resource != 0) {
+            return resource;
+        }
+    }
+    Resource *resource;
+    if (type == SPRITE) {
+        resource = Sprite::load(dataDirectory, id, name);
+    } else {
+        resource = Tileset::load(dataDirectory, id, name);
+    }
+    if (info.exists()) {
+        _write(file, source, info, type, resource);
+    }
+    return resource;
+}
+
+QString ResourceCache::_source (ResourceType type, QString id)
+{
+    if (type == SPRITE) {
+        return "sprites/" + id + ".dat";
+    }
+    return "tilesets/" + id + ".dat";
+}
+
+QString ResourceCache::_file (QString directory, ResourceType type, QString id)
+{
+    return directory + ".sqc-cache/resources/" + QString::number(type) + "_" +
+        QString(QUrl::toPercentEncoding(id)) + ".bin";
+}
+
+Resource *ResourceCache::_read (
+    QString file, QString source, const QFileInfo &info,
+    ResourceType type, QString id, QString name
+) {
+    QFile f(file);
+    if (!f.open(QIODevice::ReadOnly)) {
+        return 0;
+    }
+    QByteArray buffer;
+    const char *data = 0;
+    qint64 size = f.size();
+    if (size > 0) {
+        data = (const char *)f.map(0, size);
+    }
+    if (data == 0) {
+        buffer = f.readAll();
+        data = buffer.constData();
+        size = buffer.size();
+    }
+    QByteArray raw = QByteArray::fromRawData(data, size);
+    QDataStream in(raw);
+    in.setVersion(QDataStream::Qt_5_0);
+    quint32 magic, version;
+    QString path;
+    qint64 sourceSize, modified;
+    in >> magic >> version >> path >> sourceSize >> modified;
+    if (
+        in.status() != QDataStream::Ok || magic != CACHE_MAGIC ||
+        version != CACHE_VERSION || path != source ||
+        sourceSize != info.size() ||
+        modified != info.lastModified().toMSecsSinceEpoch()
+    ) {
+        return 0;
+    }
+    Resource *resource;
+    if (type == SPRITE) {
+        resource = _readSprite(in, id, name);
+    } else {
+        resource = _readTileset(in, id, name);
+    }
+    if (resource != 0 && in.status() != QDataStream::Ok) {
+        delete resource;
+        return 0;
+    }
+    return resource;
+}
+
+void ResourceCache::_write (
+    QString file, QString source, const QFileInfo &info,
+    ResourceType type, const Resource *resource
+) {
+    QDir dir;
+    if (!dir.mkpath(QFileInfo(file).absolutePath())) {
+        return;
+    }
+    QSaveFile f(file);
+    if (!f.open(QIODevice::WriteOnly)) {
+        return;
+    }
+    QDataStream out(&f);
+    out.setVersion(QDataStream::Qt_5_0);
+    out << (quint32)CACHE_MAGIC << (quint32)CACHE_VERSION << source;
+    out << info.size() << info.lastModified().toMSecsSinceEpoch();
+    if (type == SPRITE) {
+        _writeSprite(out, (const Sprite *)resource);
+    } else {
+        _writeTileset(out, (const Tileset *)resource);
+    }
+    if (out.status() == QDataStream::Ok) {
+        f.commit();
+    } else {
+        f.cancelWriting();
+    }
+}
+
+Sprite *ResourceCache::_readSprite (QDataStream &in, QString id, QString name)
+{
+    Sprite *sprite = new Sprite(id, name);
+    quint32 nbAnimations;
+    in >> nbAnimations;
+    try {
+        for (
+            quint32 i = 0;
+            i < nbAnimations && in.status() == QDataStream::Ok; ++i
+        ) {
+            QString animationName, image;
+            qint32 frameDelay, frameOnLoop, nbDirections;
+            in >> animationName >> image >> frameDelay >> frameOnLoop;
+            in >> nbDirections;
+            SpriteAnimation &animation =
+                sprite->_data->animations[animationName];
+            animation = SpriteAnimation(
+                animationName, image, frameDelay, frameOnLoop
+            );
+            for (
+                qint32 j = 0;
+                j < nbDirections && in.status() == QDataStream::Ok; ++j
+            ) {
+                qint32 v[8];
+                for (int k = 0; k < 8; ++k) {
+                    in >> v[k];
+                }
+                animation.addDirection(SpriteDirection(
+                    v[0], v[1], v[2], v[3], v[4], v[5], v[6], v[7]
+                ));
+            }
+            sprite->_indexAnimation(animationName);
+        }
+    } catch (const SQCException &ex) {
+        delete sprite;
+        return 0;
+    }
+    return sprite;
+}
+
+void ResourceCache::_writeSprite (QDataStream &out, const Sprite *sprite)
+{
+    const QMap<QString, SpriteAnimation> &animations =
+        sprite->_data->animations;
+    out << (quint32)animations.size();
+    QMap<QString, SpriteAnimation>::ConstIterator it = animations.begin();
+    for (; it != animations.end(); ++it) {
+        const SpriteAnimation &animation = it.value();
+        QList<SpriteDirection> directions = animation.allDirections();
+        out << animation.name() << animation.image();
+        out << (qint32)animation.frameDelay();
+        out << (qint32)animation.frameOnLoop();
+        out << (qint32)directions.size();
+        for (int i = 0; i < directions.size(); ++i) {
+            const SpriteDirection &direction = directions[i];
+            out << (qint32)direction.x() << (qint32)direction.y();
+            out << (qint32)direction.width() << (qint32)direction.height();
+            out << (qint32)direction.originX() << (qint32)direction.originY();
+            out << (qint32)direction.nbFrames();
+            out << (qint32)direction.nbColumns();
+        }
+    }
+}
+
+Tileset *ResourceCache::_readTileset (
+    QDataStream &in, QString id, QString name
+) {
+    Tileset *tileset = new Tileset(id, name);
+    quint8 red, green, blue;
+    qint32 uniquePatternId;
+    quint32 nbPatterns;
+    in >> red >> green >> blue >> uniquePatternId >> nbPatterns;
+    tileset->_data->backgroundColor = (Color){
+        (char)red, (char)green, (char)blue
+    };
+    tileset->_data->uniquePatternId = uniquePatternId;
+    try {
+        for (
+            quint32 i = 0;
+            i < nbPatterns && in.status() == QDataStream::Ok; ++i
+        ) {
+            qint32 v[7];
+            for (int k = 0; k < 7; ++k) {
+                in >> v[k];
+            }
+            int x[3], y[3];
+            for (int k = 0; k < 3; ++k) {
+                qint32 px, py;
+                in >> px >> py;
+                x[k] = px;
+                y[k] = py;
+            }
+            if (
+                v[1] < TRAVERSABLE || v[1] > LAVA ||
+                v[5] < NO_SCROLLING || v[5] > PARALLAX ||
+                Tileset::_checkPattern(v[0], v[2], v[3], v[4], v[6], v[6]) != 0
+            ) {
+                // Entrée corrompue : traitée comme absente du cache.
+                delete tileset;
+                return 0;
+            }
+            tileset->_loadPattern(Tileset::_newPattern(
+                v[0], (Ground)v[1], v[2], v[3], v[4], v[5], x, y, v[6]
+            ));
+        }
+    } catch (const SQCException &ex) {
+        delete tileset;
+        return 0;
+    }
+    return tileset;
+}
+
+void ResourceCache::_writeTileset (QDataStream &out, const Tileset *tileset)
+{
+    const TilesetData *data = tileset->_data.constData();
+    out << (quint8)data->backgroundColor.red;
+    out << (quint8)data->backgroundColor.green;
+    out << (quint8)data->backgroundColor.blue;
+    out << (qint32)data->uniquePatternId;
+    out << (quint32)data->tilePatterns.size();
+    QMap<int, TilePattern>::ConstIterator it = data->tilePatterns.begin();
+    for (; it != data->tilePatterns.end(); ++it) {
+        const TilePattern &pattern = it.value();
+        int nbPositions = 1;
+        if (pattern.isAnimated()) {
+            nbPositions = pattern.isSeq0121() ? 4 : 3;
+        }
+        out << (qint32)pattern.id() << (qint32)pattern.ground();
+        out << (qint32)pattern.defaultLayer() << (qint32)pattern.width();
+        out << (qint32)pattern.height() << (qint32)pattern.scrolling();
+        out << (qint32)nbPositions;
+        out << (qint32)pattern.x() << (qint32)pattern.y();
+        out << (qint32)pattern.x2() << (qint32)pattern.y2();
+        out << (qint32)pattern.x3() << (qint32)pattern.y3();
+    }
+}
@@ -0,0 +1,163 @@
+/*
+ * Solarus Quest Creator - GUI to build games for Solarus engine
+ * Copyright (C) 2013, Van den Branden Maxime <max.van.den.branden@gmail.com>
+ *
+ * Licensed under the EUPL, Version 1.1
+ * You may not use this work except in compliance with the Licence.
+ * You may obtain a copy of the Licence at:
+ *
+ * http://ec.europa.eu/idabc/eupl
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the Licence is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the Licence for the specific language governing permissions and
+ * limitations under the Licence.
+ */
+#include <QMutexLocker>
+#include "sol/ResourceLoader.h"
+#include "sol/Quest.h"
+#include "sol/ResourceCache.h"
+
+ResourceLoader::ResourceLoader (Quest *quest) :
+    _quest(quest),
+    _directory(quest->directory()),
+    _total(0),
+    _loaded(0),
+    _canceled(false),
+    _flushPending(false)
+{}
+
+ResourceLoader::~ResourceLoader ()
+{
+    _mutex.lock();
+    _canceled = true;
+    _mutex.unlock();
+    _pool.waitForDone();
+    for (int type = MAP; type < N_RESOURCE_TYPE; ++type) {
+        QMap<QString, Entry>::Iterator it = _entries[type].begin();
+        for (; it != _entries[type].end(); ++it) {
+            delete it.value().resource;
+        }
+    }
+}
+
+void ResourceLoader::load (ResourceType type, QString id, QString name)
+{
+    QMutexLocker locker(&_mutex);
+    if (_entries[type].contains(id)) {
+        return;
+    }
+    Entry entry;
+    entry.state = QUEUED;
+    entry.resource = 0;
+    _entries[type][id] = entry;
+    _total++;
+    _pool.start(new Task(this, type, id, name));
+}
+
+Resource *ResourceLoader::take (ResourceType type, QString id)
+{
+    QMutexLocker locker(&_mutex);
+    if (!_entries[type].contains(id)) {
+        return 0;
+    }
+    while (_entries[type][id].state == RUNNING) {
+        _finished.wait(&_mutex);
+    }
+    Entry entry = _entries[type].take(id);
+    if (entry.state == QUEUED) {
+        _loaded++;
+        _scheduleFlush();
+    }
+    return entry.resource;
+}
+
+int ResourceLoader::total () const
+{
+    QMutexLocker locker(&_mutex);
+    return _total;
+}
+
+int ResourceLoader::loaded () const
+{
+    QMutexLocker locker(&_mutex);
+    return _loaded;
+}
+
+ResourceLoader::Task::Task (ResourceLoader *loader, ResourceType type,
+                            QString id, QString name) :
+    _loader(loader),
+    _type(type),
+    _id(id),
+    _name(name)
+{}
+
+void ResourceLoader::Task::run ()
+{
+    _loader->_run(_type, _id, _name);
+}
+
+void ResourceLoader::_run (ResourceType type, QString id, QString name)
+{
+    {
+        QMutexLocker locker(&_mutex);
+        if (_canceled || !_entries[type].contains(id)) {
+            return;
+        }
+        _entries[type][id].state = RUNNING;
+    }
+    Resource *resource = 0;
+    try {
+        resource = ResourceCache::load(_directory, type, id, name);
+    } catch (...) {
+        // L'erreur sera remontée lors du chargement par la quête.
+        resource = 0;
+    }
+    QMutexLocker locker(&_mutex);
+    Entry &entry = _entries[type][id];
+    entry.state = DONE;
+    entry.resource = resource;
+    _loaded++;
+    _finished.wakeAll();
+    _scheduleFlush();
+}
+
+void ResourceLoader::_scheduleFlush ()
+{
+    if (!_flushPending && !_canceled) {
+        _flushPending = true;
+        QMetaObject::invokeMethod(this, "_flush", Qt::QueuedConnection);
+    }
+}
+
+void ResourceLoader::_flush ()
+{
+    QList<Loaded> loaded;
+    int done, total;
+    {
+        QMutexLocker locker(&_mutex);
+        _flushPending = false;
+        for (int type = MAP; type < N_RESOURCE_TYPE; ++type) {
+            QMap<QString, Entry>::Iterator it = _entries[type].begin();
+            while (it != _entries[type].end()) {
+                if (it.value().state == DONE) {
+                    Loaded l;
+                    l.type = (ResourceType)type;
+                    l.id = it.key();
+                    l.resource = it.value().resource;
+                    loaded.push_back(l);
+                    it = _entries[type].erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+        done = _loaded;
+        total = _total;
+    }
+    for (int i = 0; i < loaded.size(); ++i) {
+        _quest->_addPreloaded(loaded[i].type, loaded[i].id, loaded[i].resource);
+    }
+    _quest->_notifyPreload(done, total);
+}
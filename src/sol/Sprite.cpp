@@ -15,8 +15,6 @@
  * limitations under the Licence.
  */
 #include <QFile>
-#include <QTextStream>
-#include <QStringList>
 #include <QFileInfo>
 #include <QDir>
 #include "sol/Sprite.h"
@@ -25,23 +23,30 @@
 #include "base/Remover.h"
 #include "base/SubModelSetter.h"
 #include "base/SubModelRename.h"
+#include "base/SubModelSwap.h"
 #include "util/FileTools.h"
+#include "util/DataTokenizer.h"
 
 #define NOTIFY_SELECTION 1
 #define A_SET_ANIMATION 12
 #define A_ADD_ANIMATION 13
 #define A_REMOVE_ANIMATION 14
+#define A_SET_DIRECTION 15
+#define A_ADD_DIRECTION 16
+#define A_REMOVE_DIRECTION 17
+#define A_SWAP_DIRECTION 18
 
 const QString Sprite::p_animation = "animation";
 
 Sprite::Sprite (QString id, QString name) :
-    Resource(SPRITE, id, name)
+    Resource(SPRITE, id, name),
+    _data(new SpriteData)
 {}
 
 Sprite Sprite::copy () const
 {
     Sprite sprite(id(), _name);
-    sprite._animations = _animations;
+    sprite._data = _data;
     return sprite;
 }
 
@@ -50,47 +55,30 @@ Sprite *Sprite::load (QString dataDirectory, QString id, QString name)
 {
     QString filename = dataDirectory + "sprites/" + id + ".dat";
     if (!FileTools::fileExists(filename)) {
-        throw new IOException(IOException::FILE_N_EXISTS, filename);
+        throw IOException(IOException::FILE_N_EXISTS, filename);
     }
     QFile file(filename);
     if (!file.open(QIODevice::ReadOnly)) {
-        throw new IOException(IOException::FILE_N_READ, filename);
+        throw IOException(IOException::FILE_N_READ, filename);
+    }
+    QByteArray buffer;
+    const char *data = 0;
+    qint64 size = file.size();
+    if (size > 0) {
+        data = (const char *)file.map(0, size);
+    }
+    if (data == 0) {
+        buffer = file.readAll();
+        data = buffer.constData();
+        size = buffer.size();
     }
     Sprite *sprite = new Sprite(id, name);
-    QTextStream in(&file);
-    while (!in.atEnd()) {
-        QString line = in.readLine();
-        if (line != "") {
-            QStringList list = line.split(" ");
-            if (list.length() == 5) {
-                QString name = list[0];
-                int frameDelay = list[3].toInt();
-                int frameOnLoop = list[4].toInt();
-                SpriteAnimation animation(
-                    name, list[1], frameDelay, frameOnLoop
-                );
-                int nDirections = list[2].toInt();
-                int i = 0;
-                while (!in.atEnd() && i < nDirections) {
-                    line = in.readLine();
-                    list = line.split("\t");
-                    if (list.size() == 8) {
-                        int x = list[0].toInt();
-                        int y = list[1].toInt();
-                        int w = list[2].toInt();
-                        int h = list[3].toInt();
-                        int oX = list[4].toInt();
-                        int oY = list[5].toInt();
-                        int nF = list[6].toInt();
-                        int nC = list[7].toInt();
-                        SpriteDirection direction(x, y, w, h, oX, oY, nF, nC);
-                        animation.addDirection(direction);
-                        i++;
-                    }
-                }
-                sprite->_animations[name] = animation;
-            }
-        }
+    try {
+        DataTokenizer in(data, size);
+        sprite->_parse(in, filename);
+    } catch (...) {
+        delete sprite;
+        throw;
     }
     file.close();
     return sprite;
@@ -114,11 +102,11 @@ void Sprite::save (QString dataDirectory) throw(SQCException)
         FileTools::makeDirectory(dir);
     }
     if (!file.open(QIODevice::WriteOnly)) {
-        throw new IOException(IOException::FILE_N_WRITE, filename);
+        throw IOException(IOException::FILE_N_WRITE, filename);
     }
-    QList<QString> names = _animations.keys();
-    for (int i = 0; i < names.size(); i++) {
-        QString str = _animations[names[i]].toData();
+    QList<SpriteAnimation> animations = allAnimations();
+    for (int i = 0; i < animations.size(); i++) {
+        QString str = animations[i].toData();
         file.write(str.toLocal8Bit());
         file.write("\n\n");
     }
@@ -128,21 +116,26 @@ void Sprite::save (QString dataDirectory) throw(SQCException)
 
 bool Sprite::animationExists (QString name) const
 {
-    return _animations.contains(name);
+    return _data->animations.contains(name);
+}
+
+QList<int> Sprite::directionsAt (QString name, int x, int y) const
+{
+    return _data->directionIndex.value(name).at(x, y);
 }
 
 SpriteAnimation Sprite::animation (QString name) const throw(SQCException)
 {
     _checkAnimationExists(name);
-    return _animations[name];
+    return _data->animations[name];
 }
 
 QList<SpriteAnimation> Sprite::animations (QList<QString> names) const
 {
     QList<SpriteAnimation> list;
     for (int i = 0; i < names.size(); i++) {
-        if (_animations.contains(names[i])) {
-            list.push_back(_animations[names[i]]);
+        if (_data->animations.contains(names[i])) {
+            list.push_back(_data->animations[names[i]]);
         }
     }
     return list;
@@ -150,12 +143,12 @@ QList<SpriteAnimation> Sprite::animations (QList<QString> names) const
 
 QList<QString> Sprite::animationNames () const
 {
-    return _animations.keys();
+    return _data->animations.keys();
 }
 
 QList<SpriteAnimation> Sprite::allAnimations () const
 {
-    return _animations.values();
+    return _data->animations.values();
 }
 
 SpriteSelection Sprite::selection () const
@@ -179,7 +172,7 @@ void Sprite::setName (QString name)
 
 bool Sprite::removeAnimation (QString name)
 {
-    if (_animations.contains(name)) {
+    if (animationExists(name)) {
         QList<QString> names;
         names.push_back(name);
         doAction(new Remover<Sprite, SpriteAnimation, QString>(
@@ -193,7 +186,7 @@ bool Sprite::removeAnimation (QString name)
 
 void Sprite::setAnimation (QString name, const SpriteAnimation &animation)
 {
-    if (_animations.contains(name)) {
+    if (animationExists(name)) {
         doAction(new SubModelSetter<Sprite, SpriteAnimation, QString>(
             this, Sprite::p_animation, &Sprite::_setAnimation,
             name, SpriteAnimation(animation, name), A_SET_ANIMATION
@@ -224,6 +217,57 @@ void Sprite::renameAnimation (QString name, QString newName) throw(SQCException)
     }
 }
 
+int Sprite::addDirection (QString name, const SpriteDirection &direction)
+    throw(SQCException)
+{
+    _checkAnimationExists(name);
+    int n = animation(name).countDirections();
+    QList<SpriteDirectionId> ids;
+    QList<SpriteDirection> directions;
+    ids.push_back(SpriteDirectionId(name, n));
+    directions.push_back(direction);
+    doAction(new Adder<Sprite, SpriteDirection, SpriteDirectionId>(
+        this, Sprite::p_animation, &Sprite::_addDirections,
+        &Sprite::_removeDirections, ids, directions, A_ADD_DIRECTION
+    ));
+    return n;
+}
+
+void Sprite::removeDirection (QString name, int n) throw(SQCException)
+{
+    _checkDirectionExists(name, n);
+    QList<SpriteDirectionId> ids;
+    ids.push_back(SpriteDirectionId(name, n));
+    doAction(new Remover<Sprite, SpriteDirection, SpriteDirectionId>(
+        this, Sprite::p_animation, &Sprite::_removeDirections,
+        &Sprite::_addDirections, ids, A_REMOVE_DIRECTION
+    ));
+}
+
+void Sprite::setDirection (
+    QString name, int n, const SpriteDirection &direction
+) throw(SQCException) {
+    _checkDirectionExists(name, n);
+    doAction(new SubModelSetter<Sprite, SpriteDirection, SpriteDirectionId>(
+        this, Sprite::p_animation, &Sprite::_setDirection,
+        SpriteDirectionId(name, n), direction, A_SET_DIRECTION
+    ));
+}
+
+void Sprite::swapDirections (QString name, int n1, int n2)
+    throw(SQCException)
+{
+    _checkDirectionExists(name, n1);
+    _checkDirectionExists(name, n2);
+    if (n1 != n2) {
+        doAction(new SubModelSwap<Sprite, SpriteDirectionId>(
+            this, Sprite::p_animation, &Sprite::_swapDirections,
+            SpriteDirectionId(name, n1), SpriteDirectionId(name, n2),
+            A_SWAP_DIRECTION
+        ));
+    }
+}
+
 void Sprite::setSelection (const SpriteSelection &selection) throw(SQCException)
 {
     _checkSelection(selection);
@@ -234,19 +278,12 @@ void Sprite::setSelection (const SpriteSelection &selection) throw(SQCException)
 void Sprite::onActionNotify (Action *action, SpriteView *view)
 {
     int type = action->type();
-    if (type == A_SET_ANIMATION) {
-        QString name = (
-            (SubModelSetter<Sprite, SpriteAnimation, QString>*)action
-        )->id();
-        if (_selection.animation() == name) {
-            view->refreshAnimation(name);
-        } else {
-            _selection = SpriteSelection(name);
-            view->refreshSelection(_selection);
-        }
+    QString name = _refreshedAnimation(action);
+    if (name != "") {
+        _refreshAnimation(name, view);
     } else if (type == A_ADD_ANIMATION || type == A_REMOVE_ANIMATION) {
         QString name = ((GroupAction<QString>*)action)->selection().first();
-        if (_animations.contains(name)) {
+        if (animationExists(name)) {
             view->addAnimation(name);
         } else {
             view->removeAnimation(name);
@@ -265,6 +302,49 @@ void Sprite::onUserNotify (int userType, SpriteView *view)
     }
 }
 
+bool Sprite::onActionDefer (Action *action)
+{
+    QString name = _refreshedAnimation(action);
+    if (name != "") {
+        if (_selection.animation() == name) {
+            if (!_dirtyAnimations.contains(name)) {
+                _dirtyAnimations.push_back(name);
+            }
+        } else {
+            _selection = SpriteSelection(name);
+            userNotify(NOTIFY_SELECTION);
+        }
+        return true;
+    }
+    if (action->type() == RENAME_ACTION) {
+        SubModelRename<Sprite, QString>* rAction =
+            (SubModelRename<Sprite, QString>*)action;
+        int i = _dirtyAnimations.indexOf(rAction->oldId());
+        if (i >= 0) {
+            _dirtyAnimations[i] = rAction->newId();
+        }
+    }
+    return false;
+}
+
+void Sprite::onDeferredNotify (const QList<int> &userTypes, SpriteView *view)
+{
+    QString name = _selection.animation();
+    if (!_selection.isEmpty() && !animationExists(name)) {
+        return;
+    }
+    if (userTypes.contains(NOTIFY_SELECTION)) {
+        view->refreshSelection(_selection);
+    } else if (_dirtyAnimations.contains(name)) {
+        view->refreshAnimation(name);
+    }
+}
+
+void Sprite::clearDeferredNotify ()
+{
+    _dirtyAnimations.clear();
+}
+
 QString Sprite::_setName (QString name)
 {
     QString old = _name;
@@ -274,8 +354,9 @@ QString Sprite::_setName (QString name)
 
 SpriteAnimation Sprite::_setAnimation (QString name, SpriteAnimation animation)
 {
-    SpriteAnimation old = _animations[name];
-    _animations[name] = animation;
+    SpriteAnimation old = _data->animations[name];
+    _data->animations[name] = animation;
+    _indexAnimation(name);
     if (
         _selection.animation() == name &&
         _selection.direction() >= animation.countDirections()
@@ -289,7 +370,8 @@ void Sprite::_addAnimations (
     QList<QString> names, QList<SpriteAnimation> animations
 ) {
     QString name = names.first();
-    _animations[name] = animations.first();
+    _data->animations[name] = animations.first();
+    _indexAnimation(name);
     _selection = SpriteSelection(name);
 }
 
@@ -297,8 +379,9 @@ QList<SpriteAnimation> Sprite::_removeAnimations (QList<QString> names)
 {
     QList<SpriteAnimation> animations;
     QString name = names.first();
-    animations.push_back(_animations[name]);
-    _animations.remove(name);
+    animations.push_back(_data->animations[name]);
+    _data->animations.remove(name);
+    _data->directionIndex.remove(name);
     if (_selection.animation() == name) {
         _selection = SpriteSelection();
     }
@@ -307,13 +390,199 @@ QList<SpriteAnimation> Sprite::_removeAnimations (QList<QString> names)
 
 void Sprite::_renameAnimation (QString oldName, QString newName)
 {
-    _animations[newName] = SpriteAnimation(_animations[oldName], newName);
-    _animations.remove(oldName);
+    SpriteData *data = _data.data();
+    data->animations[newName] = SpriteAnimation(
+        data->animations[oldName], newName
+    );
+    data->animations.remove(oldName);
+    data->directionIndex[newName] = data->directionIndex.take(oldName);
+    if (_selection.animation() == oldName) {
+        if (_selection.haveDirection()) {
+            _selection = SpriteSelection(newName, _selection.direction());
+        } else if (_selection.isNewDirection()) {
+            _selection = SpriteSelection(newName, _selection.newDirection());
+        } else {
+            _selection = SpriteSelection(newName);
+        }
+    }
+}
+
+SpriteDirection Sprite::_setDirection (
+    SpriteDirectionId id, SpriteDirection direction
+) {
+    SpriteAnimation &animation = _data->animations[id.first];
+    SpriteDirection old = animation.direction(id.second);
+    animation.setDirection(id.second, direction);
+    _indexDirection(id.first, id.second);
+    _selection = SpriteSelection(id.first, id.second);
+    return old;
+}
+
+void Sprite::_addDirections (
+    QList<SpriteDirectionId> ids, QList<SpriteDirection> directions
+) {
+    for (int i = 0; i < ids.size(); i++) {
+        SpriteAnimation &animation = _data->animations[ids[i].first];
+        animation.insertDirection(ids[i].second, directions[i]);
+        _indexAnimation(ids[i].first);
+        _selection = SpriteSelection(ids[i].first, ids[i].second);
+    }
+}
+
+QList<SpriteDirection> Sprite::_removeDirections (
+    QList<SpriteDirectionId> ids
+) {
+    QList<SpriteDirection> directions;
+    for (int i = ids.size() - 1; i >= 0; i--) {
+        QString name = ids[i].first;
+        int n = ids[i].second;
+        SpriteAnimation &animation = _data->animations[name];
+        directions.push_front(animation.direction(n));
+        animation.removeDirection(n);
+        _indexAnimation(name);
+        if (_selection.animation() == name && _selection.haveDirection()) {
+            int dir = _selection.direction();
+            if (dir == n) {
+                _selection = SpriteSelection(name);
+            } else if (dir > n) {
+                _selection = SpriteSelection(name, dir - 1);
+            }
+        }
+    }
+    return directions;
+}
+
+void Sprite::_swapDirections (SpriteDirectionId id1, SpriteDirectionId id2)
+{
+    SpriteAnimation &animation = _data->animations[id1.first];
+    animation.swapDirection(id1.second, id2.second);
+    _indexDirection(id1.first, id1.second);
+    _indexDirection(id1.first, id2.second);
+    if (_selection.animation() == id1.first && _selection.haveDirection()) {
+        int dir = _selection.direction();
+        if (dir == id1.second) {
+            _selection = SpriteSelection(id1.first, id2.second);
+        } else if (dir == id2.second) {
+            _selection = SpriteSelection(id1.first, id1.second);
+        }
+    }
+}
+
+QString Sprite::_refreshedAnimation (Action *action) const
+{
+    int type = action->type();
+    if (type == A_SET_ANIMATION) {
+        return (
+            (SubModelSetter<Sprite, SpriteAnimation, QString>*)action
+        )->id();
+    } else if (type == A_SET_DIRECTION) {
+        return (
+            (SubModelSetter<Sprite, SpriteDirection, SpriteDirectionId>*)action
+        )->id().first;
+    } else if (type == A_ADD_DIRECTION || type == A_REMOVE_DIRECTION) {
+        return (
+            (GroupAction<SpriteDirectionId>*)action
+        )->selection().first().first;
+    } else if (type == A_SWAP_DIRECTION) {
+        return (
+            (SubModelSwap<Sprite, SpriteDirectionId>*)action
+        )->firstId().first;
+    }
+    return "";
+}
+
+void Sprite::_refreshAnimation (QString name, SpriteView *view)
+{
+    if (_selection.animation() == name) {
+        view->refreshAnimation(name);
+    } else {
+        _selection = SpriteSelection(name);
+        view->refreshSelection(_selection);
+    }
+}
+
+void Sprite::_indexAnimation (QString name)
+{
+    SpriteData *data = _data.data();
+    GridIndex<int> &index = data->directionIndex[name];
+    index.clear();
+    const SpriteAnimation &animation = data->animations[name];
+    for (int i = 0; i < animation.countDirections(); i++) {
+        index.insert(i, animation.direction(i).frames());
+    }
+}
+
+void Sprite::_indexDirection (QString name, int n)
+{
+    SpriteData *data = _data.data();
+    GridIndex<int> &index = data->directionIndex[name];
+    index.remove(n);
+    index.insert(n, data->animations[name].direction(n).frames());
+}
+
+void Sprite::_parse (DataTokenizer &in, QString filename) throw(SQCException)
+{
+    in.skipBlankLines();
+    while (!in.atEnd()) {
+        _indexAnimation(_parseAnimation(in, filename));
+        in.skipBlankLines();
+    }
+}
+
+QString Sprite::_parseAnimation (DataTokenizer &in, QString filename)
+    throw(SQCException)
+{
+    int line = in.line();
+    QString name, image;
+    int nbDirections, frameDelay, frameOnLoop;
+    if (
+        !in.word(&name) || !in.separator(' ') ||
+        !in.word(&image) || !in.separator(' ') ||
+        !in.integer(&nbDirections) || !in.separator(' ') ||
+        !in.integer(&frameDelay) || !in.separator(' ') ||
+        !in.integer(&frameOnLoop) || !in.endOfLine() || nbDirections < 0
+    ) {
+        throw _parseError(
+            filename, line, QObject::tr("expected an animation")
+        );
+    }
+    SpriteAnimation &animation = _data->animations[name];
+    try {
+        animation = SpriteAnimation(name, image, frameDelay, frameOnLoop);
+        for (int i = 0; i < nbDirections; ++i) {
+            line = in.line();
+            int v[8];
+            bool valid = in.integer(&v[0]);
+            for (int j = 1; j < 8 && valid; ++j) {
+                valid = in.separator('\t') && in.integer(&v[j]);
+            }
+            if (!valid || !in.endOfLine()) {
+                throw SQCException(QObject::tr("expected a direction"));
+            }
+            animation.addDirection(SpriteDirection(
+                v[0], v[1], v[2], v[3], v[4], v[5], v[6], v[7]
+            ));
+        }
+    } catch (const SQCException &ex) {
+        _data->animations.remove(name);
+        throw _parseError(filename, line, ex.message());
+    }
+    return name;
+}
+
+SQCException Sprite::_parseError (
+    QString filename, int line, QString message
+) const {
+    QString msg = QObject::tr("$1, line $2: $3");
+    msg.replace("$1", filename);
+    msg.replace("$2", QString::number(line));
+    msg.replace("$3", message);
+    return SQCException(msg);
 }
 
 void Sprite::_checkAnimationExists (QString name) const throw(SQCException)
 {
-    if (!_animations.contains(name)) {
+    if (!_data->animations.contains(name)) {
         QString message = QObject::tr("animation '$1' does not exists");
         message.replace("$1", name);
         throw SQCException(message);
@@ -322,20 +591,34 @@ void Sprite::_checkAnimationExists (QString name) const throw(SQCException)
 
 void Sprite::_checkAnimationNExists (QString name) const throw(SQCException)
 {
-    if (_animations.contains(name)) {
+    if (_data->animations.contains(name)) {
         QString message = QObject::tr("animation '$1' already exists");
         message.replace("$1", name);
         throw SQCException(message);
     }
 }
 
+void Sprite::_checkDirectionExists (QString name, int n) const
+    throw(SQCException)
+{
+    _checkAnimationExists(name);
+    if (n < 0 || n >= animation(name).countDirections()) {
+        QString msg = QObject::tr(
+            "direction $1 does not exists in animation '$2'"
+        );
+        msg.replace("$1", QString::number(n));
+        msg.replace("$2", name);
+        throw SQCException(msg);
+    }
+}
+
 void Sprite::_checkSelection (const SpriteSelection &selection) const
     throw(SQCException)
 {
     if (!selection.isEmpty()) {
         _checkAnimationExists(selection.animation());
         if (selection.haveDirection()) {
-            int count = _animations[selection.animation()].countDirections();
+            int count = animation(selection.animation()).countDirections();
             int direction = selection.direction();
             if (direction >= count || direction < 0) {
                 QString msg = QObject::tr(
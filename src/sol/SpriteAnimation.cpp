@@ -113,6 +113,16 @@ int SpriteAnimation::addDirection (const SpriteDirection &direction)
     return _directions.size() - 1;
 }
 
+void SpriteAnimation::insertDirection (
+    const int &n, const SpriteDirection &direction
+) {
+    if (n < 0 || n >= _directions.size()) {
+        _directions.push_back(direction);
+    } else {
+        _directions.insert(n, direction);
+    }
+}
+
 void SpriteAnimation::setDirection (
     const int &n, const SpriteDirection &direction
 ) {
@@ -159,6 +169,12 @@ QString SpriteAnimation::toData () const
     return data;
 }
 
+int SpriteAnimation::memoryUsage () const
+{
+    return sizeof(SpriteAnimation) + estimateMemory(_name) +
+        estimateMemory(_image) + estimateMemory(_directions);
+}
+
 void SpriteAnimation::_checkName (QString name) const throw(SQCException)
 {
     if (name == "") {
@@ -169,7 +185,7 @@ void SpriteAnimation::_checkName (QString name) const throw(SQCException)
 void SpriteAnimation::_checkDirectionExists (int n) const
     throw(SQCException)
 {
-    if (!_directions.size() > n) {
+    if (n < 0 || n >= _directions.size()) {
         QString message = QObject::tr("direction $1 does not exists");
         message.replace("$1", QString::number(n));
         throw SQCException(message);
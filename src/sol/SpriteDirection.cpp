@@ -105,6 +105,18 @@ int SpriteDirection::nbColumns () const
     return _nbColumns;
 }
 
+QList<Rect> SpriteDirection::frames () const
+{
+    QList<Rect> frames;
+    for (int i = 0; i < _nbFrames; i++) {
+        int col = i % _nbColumns, row = i / _nbColumns;
+        frames.push_back((Rect){
+            _x + col * _width, _y + row * _height, _width, _height
+        });
+    }
+    return frames;
+}
+
 void SpriteDirection::setX (const int &x) throw (SQCException)
 {
     _checkX(x);
@@ -0,0 +1,229 @@
+/*
+ * Solarus Quest Creator - GUI to build games for Solarus engine
+ * Copyright (C) 2013, Van den Branden Maxime <max.van.den.branden@gmail.com>
+ *
+ * Licensed under the EUPL, Version 1.1
+ * You may not use this work except in compliance with the Licence.
+ * You may obtain a copy of the Licence at:
+ *
+ * http://ec.europa.eu/idabc/eupl
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the Licence is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the Licence for the specific language governing permissions and
+ * limitations under the Licence.
+ */
+#include <QMutexLocker>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QDir>
+#include <QUrl>
+#include "sol/ThumbnailCache.h"
+#include "sol/Quest.h"
+#include "sol/Sprite.h"
+#include "util/SpriteRenderer.h"
+
+ThumbnailCache::ThumbnailCache (Quest *quest, QString tileset, QSize size) :
+    _quest(quest),
+    _dataDirectory(quest->dataDirectory()),
+    _directory(quest->directory() + ".sqc-cache/thumbnails/"),
+    _tileset(tileset),
+    _size(size),
+    _generation(0),
+    _canceled(false),
+    _flushPending(false)
+{}
+
+ThumbnailCache::~ThumbnailCache ()
+{
+    _mutex.lock();
+    _canceled = true;
+    _mutex.unlock();
+    _pool.waitForDone();
+}
+
+QImage ThumbnailCache::thumbnail (ResourceType type, QString id)
+{
+    if (
+        (type != SPRITE && type != TILESET) ||
+        !_quest->resourceExists(type, id)
+    ) {
+        return QImage();
+    }
+    QMutexLocker locker(&_mutex);
+    if (_entries[type].contains(id)) {
+        return _entries[type][id].image;
+    }
+    Entry entry;
+    entry.ready = false;
+    entry.generation = ++_generation;
+    _entries[type][id] = entry;
+    _pool.start(new Task(
+        this, type, id, _quest->resourceName(type, id), entry.generation
+    ));
+    return QImage();
+}
+
+void ThumbnailCache::invalidate (ResourceType type, QString id)
+{
+    QMutexLocker locker(&_mutex);
+    _entries[type].remove(id);
+}
+
+void ThumbnailCache::setTileset (QString tileset)
+{
+    QMutexLocker locker(&_mutex);
+    if (tileset != _tileset) {
+        _tileset = tileset;
+        _entries[SPRITE].clear();
+    }
+}
+
+ThumbnailCache::Task::Task (
+    ThumbnailCache *cache, ResourceType type, QString id, QString name,
+    int generation
+) :
+    _cache(cache),
+    _type(type),
+    _id(id),
+    _name(name),
+    _generation(generation)
+{}
+
+void ThumbnailCache::Task::run ()
+{
+    _cache->_run(_type, _id, _name, _generation);
+}
+
+void ThumbnailCache::_run (
+    ResourceType type, QString id, QString name, int generation
+) {
+    QString tileset;
+    {
+        QMutexLocker locker(&_mutex);
+        if (
+            _canceled || !_entries[type].contains(id) ||
+            _entries[type][id].generation != generation
+        ) {
+            return;
+        }
+        tileset = _tileset;
+    }
+    QImage image = _load(type, id, name, tileset);
+    QMutexLocker locker(&_mutex);
+    if (
+        _entries[type].contains(id) &&
+        _entries[type][id].generation == generation
+    ) {
+        Entry &entry = _entries[type][id];
+        entry.ready = true;
+        entry.image = image;
+        _ready.push_back(QPair<ResourceType, QString>(type, id));
+        _scheduleFlush();
+    }
+}
+
+QImage ThumbnailCache::_load (
+    ResourceType type, QString id, QString name, QString tileset
+) {
+    QString folder = type == SPRITE ? "sprites/" : "tilesets/";
+    QString dat = _modified(_dataDirectory + folder + id + ".dat");
+    QString file = _file(type, id);
+    QImage cached(file);
+    if (
+        !cached.isNull() && cached.text("sqc_dat_modified") == dat &&
+        (type != SPRITE || cached.text("sqc_tileset") == tileset)
+    ) {
+        QString image = cached.text("sqc_image");
+        QString modified = _modified(_dataDirectory + image);
+        if (cached.text("sqc_image_modified") == modified) {
+            return cached;
+        }
+    }
+    QString image;
+    QImage thumbnail = _generate(type, id, name, tileset, image);
+    if (thumbnail.isNull()) {
+        return thumbnail;
+    }
+    thumbnail.setText("sqc_dat_modified", dat);
+    thumbnail.setText("sqc_image", image);
+    if (type == SPRITE) {
+        thumbnail.setText("sqc_tileset", tileset);
+    }
+    thumbnail.setText("sqc_image_modified", _modified(_dataDirectory + image));
+    QDir dir;
+    if (dir.mkpath(_directory)) {
+        thumbnail.save(file, "PNG");
+    }
+    return thumbnail;
+}
+
+QImage ThumbnailCache::_generate (
+    ResourceType type, QString id, QString name, QString tileset,
+    QString &image
+) {
+    if (type == TILESET) {
+        image = "tilesets/" + id + ".tiles.png";
+        QImage tiles(_dataDirectory + image);
+        if (tiles.isNull()) {
+            return QImage();
+        }
+        return SpriteRenderer::fit(tiles, _size);
+    }
+    Sprite *sprite = 0;
+    try {
+        sprite = Sprite::load(_dataDirectory, id, name);
+    } catch (...) {
+        return QImage();
+    }
+    SpriteRenderer renderer(_dataDirectory, tileset);
+    QImage thumbnail;
+    QList<SpriteAnimation> animations = sprite->allAnimations();
+    for (int i = 0; i < animations.size() && thumbnail.isNull(); i++) {
+        thumbnail = renderer.thumbnail(animations[i], _size);
+        if (!thumbnail.isNull()) {
+            image = renderer.imagePath(animations[i]);
+            image.remove(0, _dataDirectory.size());
+        }
+    }
+    delete sprite;
+    return thumbnail;
+}
+
+QString ThumbnailCache::_file (ResourceType type, QString id) const
+{
+    return _directory + QString::number(type) + "_" +
+        QString(QUrl::toPercentEncoding(id)) + ".png";
+}
+
+QString ThumbnailCache::_modified (QString filename) const
+{
+    QFileInfo info(filename);
+    if (!info.exists()) {
+        return "";
+    }
+    return QString::number(info.lastModified().toMSecsSinceEpoch());
+}
+
+void ThumbnailCache::_scheduleFlush ()
+{
+    if (!_flushPending && !_canceled) {
+        _flushPending = true;
+        QMetaObject::invokeMethod(this, "_flush", Qt::QueuedConnection);
+    }
+}
+
+void ThumbnailCache::_flush ()
+{
+    QList<QPair<ResourceType, QString> > ready;
+    {
+        QMutexLocker locker(&_mutex);
+        _flushPending = false;
+        ready = _ready;
+        _ready.clear();
+    }
+    for (int i = 0; i < ready.size(); ++i) {
+        _quest->_notifyThumbnail(ready[i].first, ready[i].second);
+    }
+}
@@ -122,6 +122,17 @@ bool TilePattern::isAnimated () const
     return _positions.x2 >= 0;
 }
 
+QList<Rect> TilePattern::frames () const
+{
+    QList<Rect> frames;
+    frames.push_back((Rect){_positions.x1, _positions.y1, _width, _height});
+    if (isAnimated()) {
+        frames.push_back((Rect){_positions.x2, _positions.y2, _width, _height});
+        frames.push_back((Rect){_positions.x3, _positions.y3, _width, _height});
+    }
+    return frames;
+}
+
 void TilePattern::setGround (Ground ground)
 {
     _ground = ground;
@@ -18,6 +18,8 @@
 #include <QObject>
 #include "sol/Tileset.h"
 #include "sol/TilePattern.h"
+#include "sol/LuaStatePool.h"
+#include "sol/TilesetParser.h"
 #include "base/Setter.h"
 #include "base/Adder.h"
 #include "base/Remover.h"
@@ -28,66 +30,83 @@
 #define A_ADD_PATTERN 13
 #define A_REMOVE_PATTERN 14
 
+#define UPVALUE_KEYS 1
+#define UPVALUE_GROUNDS 2
+#define UPVALUE_SCROLLINGS 3
+
 const QString Tileset::p_backgroundColor = "background_color";
 const QString Tileset::p_tilePattern = "tile_pattern";
 
+const char *Tileset::_keyNames[] = {
+    "id", "ground", "default_layer", "x", "y", "width", "height", "scrolling"
+};
+const char *Tileset::_groundNames[] = {
+    "traversable", "wall", "wall_top_right", "wall_top_left",
+    "wall_bottom_left", "wall_bottom_right", "empty", "water_top_right",
+    "water_top_left", "water_bottom_left", "water_bottom_right",
+    "deep_water", "shallow_water", "hole", "ladder", "prickles", "lava"
+};
+const char *Tileset::_scrollingNames[] = {"", "self", "parallax"};
+
 Tileset *Tileset::load (QString dataDirectory, QString id, QString name)
     throw(SQCException)
 {
     Tileset *tileset = new Tileset(id, name);
-    lua_State *L = luaL_newstate();
-    lua_register(L, "background_color", _lua_backgroundColor);
-    lua_register(L, "tile_pattern", _lua_tilePattern);
-    lua_pushlightuserdata(L, tileset);
-    lua_setfield(L, LUA_REGISTRYINDEX, "tileset");
     QString filename = dataDirectory + tileset->filename();
-    if (luaL_loadfile(L, filename.toStdString().c_str())) {
-        throw SQCException(QObject::tr("lua load error"));
+    if (!TilesetParser::load(tileset, filename)) {
+        try {
+            LuaStatePool::Lease lua;
+            lua.setUserData("tileset", tileset);
+            lua.run(filename);
+        } catch (...) {
+            delete tileset;
+            throw;
+        }
     }
-    if (lua_pcall(L, 0, 0, 0) != 0) {
-        throw SQCException(QObject::tr("lua call error"));
+    TilesetData *data = tileset->_data.data();
+    if (!data->tilePatterns.isEmpty()) {
+        data->uniquePatternId = data->tilePatterns.lastKey();
     }
-    lua_close(L);
     return tileset;
 }
 
 Tileset::Tileset (QString id, QString name) :
     Resource(TILESET, id, name),
-    _backgroundColor((Color){255, 255, 255}),
-    _uniquePatternId(0)
-{}
+    _data(new TilesetData)
+{
+    _data->backgroundColor = (Color){255, 255, 255};
+    _data->uniquePatternId = 0;
+}
 
 Tileset Tileset::copy () const
 {
     Tileset tileset(id(), _name);
-    tileset._backgroundColor = _backgroundColor;
-    tileset._tilePatterns = _tilePatterns;
-    tileset._uniquePatternId = _uniquePatternId;
+    tileset._data = _data;
     return tileset;
 }
 
 Color Tileset::backgroundColor () const
 {
-    return _backgroundColor;
+    return _data->backgroundColor;
 }
 
 bool Tileset::patternExists (int id) const
 {
-    return _tilePatterns.contains(id);
+    return _data->tilePatterns.contains(id);
 }
 
 TilePattern Tileset::pattern (int id) const throw(SQCException)
 {
     _checkPatternExists(id);
-    return _tilePatterns[id];
+    return _data->tilePatterns[id];
 }
 
 QList<TilePattern> Tileset::patterns(QList<int> ids) const
 {
     QList<TilePattern> list;
     for (int i = 0; i < ids.size(); i++) {
-        if (_tilePatterns.contains(ids[i])) {
-            list.push_back(_tilePatterns[ids[i]]);
+        if (_data->tilePatterns.contains(ids[i])) {
+            list.push_back(_data->tilePatterns[ids[i]]);
         }
     }
     return list;
@@ -95,12 +114,22 @@ QList<TilePattern> Tileset::patterns(QList<int> ids) const
 
 QList<int> Tileset::patternIds() const
 {
-    return _tilePatterns.keys();
+    return _data->tilePatterns.keys();
+}
+
+QList<int> Tileset::patternsAt (int x, int y) const
+{
+    return _data->patternIndex.at(x, y);
+}
+
+QList<int> Tileset::patternsIn (const Rect &rect) const
+{
+    return _data->patternIndex.intersecting(rect);
 }
 
 QList<TilePattern> Tileset::allPatterns() const
 {
-    return _tilePatterns.values();
+    return _data->tilePatterns.values();
 }
 
 QList<TilePattern> Tileset::patternSelection () const
@@ -134,7 +163,7 @@ void Tileset::setName (QString name)
 
 void Tileset::setBackgroundColor (Color color)
 {
-    if (color != _backgroundColor) {
+    if (color != backgroundColor()) {
         doAction(new Setter<Tileset, Color>(
             this, Tileset::p_backgroundColor,
             &Tileset::_setBackgroundColor, color
@@ -144,7 +173,7 @@ void Tileset::setBackgroundColor (Color color)
 
 int Tileset::addPattern (const TilePattern &pattern)
 {
-    int id = ++_uniquePatternId;
+    int id = ++_data->uniquePatternId;
     QList<int> ids;
     QList<TilePattern> patterns;
     ids.push_back(id);
@@ -160,7 +189,7 @@ QList<int> Tileset::addPatterns(QList<TilePattern> patterns)
 {
     QList<int> ids;
     for (int i = 0; i < patterns.size(); i++) {
-        ids.push_back(++_uniquePatternId);
+        ids.push_back(++_data->uniquePatternId);
     }
     doAction(new Adder<Tileset, TilePattern, int>(
         this, Tileset::p_tilePattern, &Tileset::_addPatterns,
@@ -201,7 +230,7 @@ bool Tileset::removeSelectionPatterns () throw(SQCException)
 
 void Tileset::setPattern (int id, const TilePattern &pattern)
 {
-    if (_tilePatterns.contains(id)) {
+    if (patternExists(id)) {
         doAction(new SubModelSetter<Tileset, TilePattern, int>(
             this, Tileset::p_tilePattern, &Tileset::_setPattern,
             id, TilePattern(pattern, id), A_SET_PATTERN
@@ -220,7 +249,7 @@ void Tileset::setPattern (int id, const TilePattern &pattern)
 
 void Tileset::selectPattern (int id)
 {
-    if (_tilePatterns.contains(id)) {
+    if (patternExists(id)) {
         _selection.push_back(id);
         userNotify(NOTIFY_SELECTION);
     }
@@ -234,6 +263,17 @@ void Tileset::unselectPattern (int id)
     }
 }
 
+void Tileset::setSelection (QList<int> ids)
+{
+    _selection.clear();
+    for (int i = 0; i < ids.size(); i++) {
+        if (patternExists(ids[i])) {
+            _selection.push_back(ids[i]);
+        }
+    }
+    userNotify(NOTIFY_SELECTION);
+}
+
 void Tileset::onActionNotify (Action *action, TilesetView *view)
 {
     int type = action->type();
@@ -266,15 +306,17 @@ QString Tileset::_setName (QString name)
 
 Color Tileset::_setBackgroundColor (Color color)
 {
-    Color old = _backgroundColor;
-    _backgroundColor = color;
+    Color old = _data->backgroundColor;
+    _data->backgroundColor = color;
     return old;
 }
 
 TilePattern Tileset::_setPattern (int id, TilePattern pattern)
 {
-    TilePattern old = _tilePatterns[id];
-    _tilePatterns[id] = pattern;
+    TilePattern old = _data->tilePatterns[id];
+    _data->tilePatterns[id] = pattern;
+    _data->patternIndex.remove(id);
+    _data->patternIndex.insert(id, pattern.frames());
     _selection.clear();
     _selection.push_back(id);
     return old;
@@ -283,7 +325,8 @@ TilePattern Tileset::_setPattern (int id, TilePattern pattern)
 void Tileset::_addPatterns (QList<int> ids, QList<TilePattern> patterns)
 {
     for (int i = 0; i < ids.size(); i++) {
-        _tilePatterns[ids[i]] = patterns[i];
+        _data->tilePatterns[ids[i]] = patterns[i];
+        _data->patternIndex.insert(ids[i], patterns[i].frames());
     }
     _selection = ids;
 }
@@ -292,15 +335,16 @@ QList<TilePattern> Tileset::_removePatterns(QList<int> ids)
 {
     QList<TilePattern> patterns;
     for (int i = 0; i < ids.size(); i++) {
-        patterns.push_back(_tilePatterns[ids[i]]);
-        _tilePatterns.remove(ids[i]);
+        patterns.push_back(_data->tilePatterns[ids[i]]);
+        _data->tilePatterns.remove(ids[i]);
+        _data->patternIndex.remove(ids[i]);
     }
     return patterns;
 }
 
 void Tileset::_checkPatternExists (int id) const throw(SQCException)
 {
-    if (!_tilePatterns.contains(id)) {
+    if (!_data->tilePatterns.contains(id)) {
         QString message = QObject::tr("tile_pattern $1 does not exists");
         message.replace("$1", QString::number(id));
         throw SQCException(message);
@@ -312,6 +356,9 @@ int Tileset::_lua_backgroundColor (lua_State *L)
     lua_getfield(L, LUA_REGISTRYINDEX, "tileset");
     Tileset* tileset = (Tileset*)lua_touserdata(L, -1);
     lua_pop(L, 1);
+    if (tileset == 0) {
+        return luaL_error(L, "tileset is not available in this file");
+    }
 
     luaL_checktype(L, 1, LUA_TTABLE);
     lua_rawgeti(L, 1, 1);
@@ -324,34 +371,71 @@ int Tileset::_lua_backgroundColor (lua_State *L)
     };
     lua_pop(L, 3);
 
-    tileset->_backgroundColor = color;
+    tileset->_data->backgroundColor = color;
     return 0;
 }
 
+void Tileset::_luaRegister (lua_State *L)
+{
+    lua_register(L, "background_color", _lua_backgroundColor);
+    _luaPushLookup(L, _keyNames, N_PATTERN_KEY);
+    _luaPushLookup(L, _groundNames, LAVA + 1);
+    _luaPushLookup(L, _scrollingNames, PARALLAX + 1);
+    lua_pushcclosure(L, _lua_tilePattern, 3);
+    lua_setglobal(L, "tile_pattern");
+}
+
+void Tileset::_luaPushLookup (lua_State *L, const char **names, int n)
+{
+    lua_createtable(L, 0, n);
+    for (int i = 0; i < n; ++i) {
+        lua_pushinteger(L, i);
+        lua_setfield(L, -2, names[i]);
+    }
+}
+
+int Tileset::_luaLookup (lua_State *L, int index, int upvalue)
+{
+    if (lua_type(L, index) != LUA_TSTRING) {
+        return -1;
+    }
+    lua_pushvalue(L, index);
+    lua_rawget(L, lua_upvalueindex(upvalue));
+    int value = lua_isnumber(L, -1) ? lua_tointeger(L, -1) : -1;
+    lua_pop(L, 1);
+    return value;
+}
+
 int Tileset::_lua_tilePattern (lua_State *L)
 {
     lua_getfield(L, LUA_REGISTRYINDEX, "tileset");
     Tileset* tileset = (Tileset*)lua_touserdata(L, -1);
     lua_pop(L, 1);
+    if (tileset == 0) {
+        return luaL_error(L, "tileset is not available in this file");
+    }
 
     int id = -1, default_layer = -1, width = 0, height = 0;
     int x[] = { -1, -1, -1, -1 };
     int y[] = { -1, -1, -1, -1 };
     Ground ground = TRAVERSABLE;
-    QString scrolling;
+    int scrolling = NO_SCROLLING;
     int i = 0, j = 0;
 
     lua_settop(L, 1);
     lua_pushnil(L);
     while (lua_next(L, 1) != 0) {
-        QString key = luaL_checkstring(L, 2);
-        if (key == "id") {
+        switch (_luaLookup(L, 2, UPVALUE_KEYS)) {
+        case KEY_ID:
             id = luaL_checkinteger(L, 3);
-        } else if (key == "ground") {
+            break;
+        case KEY_GROUND:
             ground = _checkGround(L, 3);
-        } else if (key == "default_layer") {
+            break;
+        case KEY_DEFAULT_LAYER:
             default_layer = luaL_checkinteger(L, 3);
-        } else if (key == "x") {
+            break;
+        case KEY_X:
             if (lua_isnumber(L, 3)) {
                 x[0] = luaL_checkinteger(L, 3);
                 i = 1;
@@ -363,104 +447,107 @@ int Tileset::_lua_tilePattern (lua_State *L)
                     lua_pop(L, 1);
                 }
             }
-        } else if (key == "y") {
+            break;
+        case KEY_Y:
             if (lua_isnumber(L, 3)) {
-            y[0] = luaL_checkinteger(L, 3);
-            j = 1;
-        } else {
-            lua_pushnil(L);
-            while (lua_next(L, 3) != 0 && j < 4) {
-                y[j] = luaL_checkinteger(L, 5);
-                ++j;
-                lua_pop(L, 1);
+                y[0] = luaL_checkinteger(L, 3);
+                j = 1;
+            } else {
+                lua_pushnil(L);
+                while (lua_next(L, 3) != 0 && j < 4) {
+                    y[j] = luaL_checkinteger(L, 5);
+                    ++j;
+                    lua_pop(L, 1);
+                }
             }
-        }
-        } else if (key == "width") {
+            break;
+        case KEY_WIDTH:
             width = luaL_checkinteger(L, 3);
-        } else if (key == "height") {
+            break;
+        case KEY_HEIGHT:
             height = luaL_checkinteger(L, 3);
-        } else if (key == "scrolling") {
-            scrolling = luaL_checkstring(L, 3);
+            break;
+        case KEY_SCROLLING:
+            luaL_checkstring(L, 3);
+            scrolling = _luaLookup(L, 3, UPVALUE_SCROLLINGS);
+            break;
         }
         lua_pop(L, 1);
     }
 
+    const char *error = _checkPattern(id, default_layer, width, height, i, j);
+    if (error != 0) {
+        luaL_argerror(L, 1, error);
+    }
+    tileset->_loadPattern(_newPattern(
+        id, ground, default_layer, width, height, scrolling, x, y, i
+    ));
+    return 0;
+}
+
+const char *Tileset::_checkPattern (
+    int id, int defaultLayer, int width, int height, int nbX, int nbY
+) {
     if (id == -1) {
-        luaL_argerror(L, 1, "Missing id for this tile pattern");
+        return "Missing id for this tile pattern";
+    }
+    if (defaultLayer == -1) {
+        return "Missing default layer for this tile pattern";
     }
-    if (default_layer == -1) {
-        luaL_argerror(L, 1, "Missing default layer for this tile pattern");
+    if (defaultLayer < LOW || defaultLayer > HIGH) {
+        return "Invalid default layer for this tile pattern";
     }
     if (width == 0) {
-        luaL_argerror(L, 1, "Missing width for this tile pattern");
+        return "Missing width for this tile pattern";
     }
     if (height == 0) {
-        luaL_argerror(L, 1, "Missing height for this tile pattern");
+        return "Missing height for this tile pattern";
     }
-    if (i != 1 && i != 3 && i != 4) {
-        luaL_argerror(L, 1, "Invalid number of frames for x");
+    if (nbX != 1 && nbX != 3 && nbX != 4) {
+        return "Invalid number of frames for x";
     }
-    if (j != 1 && j != 3 && j != 4) {
-        luaL_argerror(L, 1, "Invalid number of frames for y");
+    if (nbY != 1 && nbY != 3 && nbY != 4) {
+        return "Invalid number of frames for y";
     }
-    if (i != j) {
-        luaL_argerror(L, 1, "The length of x and y must match");
+    if (nbX != nbY) {
+        return "The length of x and y must match";
     }
+    return 0;
+}
 
+TilePattern Tileset::_newPattern (
+    int id, Ground ground, int defaultLayer, int width, int height,
+    int scrolling, const int *x, const int *y, int nbPositions
+) throw(SQCException) {
     TilePattern pattern(id);
     pattern.setGround(ground);
-    pattern.setDefaultLayer((Layer)default_layer);
+    pattern.setDefaultLayer((Layer)defaultLayer);
     pattern.setWidth(width);
     pattern.setHeight(height);
-    if (scrolling == "self") {
-        pattern.setScrolling(SELF);
-    } else if (scrolling == "parallax") {
-        pattern.setScrolling(PARALLAX);
+    if (scrolling > NO_SCROLLING) {
+        pattern.setScrolling((Scrolling)scrolling);
     }
-    if (i >= 3) {
-        bool seq = i == 4;
+    if (nbPositions >= 3) {
+        bool seq = nbPositions == 4;
         pattern.setPositions(x[0], y[0], x[1], y[1], x[2], y[2], seq);
     } else {
         pattern.setPosition(x[0], y[0]);
     }
-    tileset->_tilePatterns[id] = pattern;
+    return pattern;
+}
+
+void Tileset::_loadPattern (const TilePattern &pattern)
+{
+    _data->tilePatterns[pattern.id()] = pattern;
+    _data->patternIndex.insert(pattern.id(), pattern.frames());
 }
 
 Ground Tileset::_checkGround (lua_State *L, int index)
 {
-    const QString name = luaL_checkstring(L, index);
-    if (name == "wall") {
-        return WALL;
-    } else if (name == "wall_top_right") {
-        return WALL_TOP_RIGHT;
-    } else if (name == "wall_top_left") {
-        return WALL_TOP_LEFT;
-    } else if (name == "wall_bottom_left") {
-        return WALL_BOTTOM_LEFT;
-    } else if (name == "wall_bottom_right") {
-        return WALL_BOTTOM_RIGHT;
-    } else if (name == "wall_empty") {
-        return EMPTY;
-    } else if (name == "water_top_right") {
-        return WATER_TOP_RIGHT;
-    } else if (name == "water_top_left") {
-        return WATER_TOP_LEFT;
-    } else if (name == "water_bottom_left") {
-        return WATER_BOTTOM_LEFT;
-    } else if (name == "water_bottom_right") {
-        return WATER_BOTTOM_RIGHT;
-    } else if (name == "deep_water") {
-        return DEEP_WATER;
-    } else if (name == "shallow_water") {
-        return SHALLOW_WATER;
-    } else if (name == "hole") {
-        return HOLE;
-    } else if (name == "ladder") {
-        return LADDER;
-    } else if (name == "pickles") {
-        return PRICKLES;
-    } else if (name == "lava") {
-        return LAVA;
-    }
-    return TRAVERSABLE;
+    luaL_checkstring(L, index);
+    int ground = _luaLookup(L, index, UPVALUE_GROUNDS);
+    if (ground < 0) {
+        return TRAVERSABLE;
+    }
+    return (Ground)ground;
 }
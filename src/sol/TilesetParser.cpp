@@ -0,0 +1,323 @@
+/*
+ * Solarus Quest Creator - GUI to build games for Solarus engine
+ * Copyright (C) 2013, Van den Branden Maxime <max.van.den.branden@gmail.com>
+ *
+ * Licensed under the EUPL, Version 1.1
+ * You may not use this work except in compliance with the Licence.
+ * You may obtain a copy of the Licence at:
+ *
+ * http://ec.europa.eu/idabc/eupl
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the Licence is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the Licence for the specific language governing permissions and
+ * limitations under the Licence.
+ */
+#include <ctype.h>
+#include <QFile>
+#include "sol/TilesetParser.h"
+
+bool TilesetParser::load (Tileset *tileset, QString filename)
+{
+    QFile file(filename);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    QByteArray buffer;
+    const char *data = 0;
+    qint64 size = file.size();
+    if (size > 0) {
+        data = (const char *)file.map(0, size);
+    }
+    if (data == 0) {
+        buffer = file.readAll();
+        data = buffer.constData();
+        size = buffer.size();
+    }
+    TilesetParser parser(data, size);
+    if (!parser._parse()) {
+        return false;
+    }
+    if (parser._hasBackgroundColor) {
+        tileset->_data->backgroundColor = parser._backgroundColor;
+    }
+    for (int i = 0; i < parser._patterns.size(); ++i) {
+        tileset->_loadPattern(parser._patterns[i]);
+    }
+    return true;
+}
+
+TilesetParser::TilesetParser (const char *data, qint64 size) :
+    _current(data),
+    _end(data + size),
+    _unsupported(false),
+    _hasBackgroundColor(false)
+{}
+
+bool TilesetParser::_parse ()
+{
+    _skipSpaces();
+    while (_current < _end) {
+        const char *name;
+        int length;
+        if (!_name(&name, &length)) {
+            return false;
+        }
+        bool parenthesis = _symbol('(');
+        bool valid;
+        if (length == 16 && qstrncmp(name, "background_color", 16) == 0) {
+            valid = _backgroundColorCall();
+        } else if (length == 12 && qstrncmp(name, "tile_pattern", 12) == 0) {
+            valid = _tilePatternCall();
+        } else {
+            return false;
+        }
+        if (!valid || (parenthesis && !_symbol(')'))) {
+            return false;
+        }
+        _symbol(';');
+    }
+    return !_unsupported;
+}
+
+bool TilesetParser::_backgroundColorCall ()
+{
+    Value value;
+    if (!_list(&value) || value.count < 3) {
+        return false;
+    }
+    _backgroundColor = (Color){
+        (char)value.list[0], (char)value.list[1], (char)value.list[2]
+    };
+    _hasBackgroundColor = true;
+    return true;
+}
+
+bool TilesetParser::_tilePatternCall ()
+{
+    int id = -1, defaultLayer = -1, width = 0, height = 0;
+    int x[] = { -1, -1, -1, -1 };
+    int y[] = { -1, -1, -1, -1 };
+    int nbX = 0, nbY = 0;
+    Ground ground = TRAVERSABLE;
+    int scrolling = NO_SCROLLING;
+
+    if (!_symbol('{')) {
+        return false;
+    }
+    while (!_symbol('}')) {
+        const char *key;
+        int length;
+        Value value;
+        if (!_name(&key, &length) || !_symbol('=') || !_value(&value)) {
+            return false;
+        }
+        int code = _lookup(
+            Tileset::_keyNames, Tileset::N_PATTERN_KEY, key, length
+        );
+        if (code == Tileset::KEY_X || code == Tileset::KEY_Y) {
+            int *positions = code == Tileset::KEY_X ? x : y;
+            int *count = code == Tileset::KEY_X ? &nbX : &nbY;
+            if (value.type == INTEGER) {
+                positions[0] = value.integer;
+                *count = 1;
+            } else if (value.type == LIST) {
+                for (int i = 0; i < value.count; ++i) {
+                    positions[i] = value.list[i];
+                }
+                *count = value.count;
+            } else {
+                return false;
+            }
+        } else if (
+            code == Tileset::KEY_GROUND || code == Tileset::KEY_SCROLLING
+        ) {
+            if (value.type != STRING) {
+                return false;
+            }
+            if (code == Tileset::KEY_GROUND) {
+                int n = _lookup(
+                    Tileset::_groundNames, LAVA + 1, value.string, value.length
+                );
+                ground = n < 0 ? TRAVERSABLE : (Ground)n;
+            } else {
+                scrolling = _lookup(
+                    Tileset::_scrollingNames, PARALLAX + 1,
+                    value.string, value.length
+                );
+            }
+        } else if (code >= 0) {
+            if (value.type != INTEGER) {
+                return false;
+            }
+            if (code == Tileset::KEY_ID) {
+                id = value.integer;
+            } else if (code == Tileset::KEY_DEFAULT_LAYER) {
+                defaultLayer = value.integer;
+            } else if (code == Tileset::KEY_WIDTH) {
+                width = value.integer;
+            } else if (code == Tileset::KEY_HEIGHT) {
+                height = value.integer;
+            }
+        }
+        if (!_symbol(',') && !_symbol(';')) {
+            if (!_symbol('}')) {
+                return false;
+            }
+            break;
+        }
+    }
+    if (Tileset::_checkPattern(id, defaultLayer, width, height, nbX, nbY)) {
+        return false;
+    }
+    try {
+        _patterns.push_back(Tileset::_newPattern(
+            id, ground, defaultLayer, width, height, scrolling, x, y, nbX
+        ));
+    } catch (const SQCException &ex) {
+        return false;
+    }
+    return true;
+}
+
+bool TilesetParser::_value (Value *value)
+{
+    if (_current < _end && (*_current == '"' || *_current == '\'')) {
+        value->type = STRING;
+        return _string(&value->string, &value->length);
+    }
+    if (_current < _end && *_current == '{') {
+        return _list(value);
+    }
+    value->type = INTEGER;
+    return _integer(&value->integer);
+}
+
+bool TilesetParser::_list (Value *value)
+{
+    value->type = LIST;
+    value->count = 0;
+    if (!_symbol('{')) {
+        return false;
+    }
+    while (!_symbol('}')) {
+        if (value->count == 4 || !_integer(&value->list[value->count])) {
+            return false;
+        }
+        value->count++;
+        if (!_symbol(',') && !_symbol(';')) {
+            if (!_symbol('}')) {
+                return false;
+            }
+            break;
+        }
+    }
+    return true;
+}
+
+bool TilesetParser::_name (const char **name, int *length)
+{
+    const char *c = _current;
+    if (c >= _end || !(isalpha((uchar)*c) || *c == '_')) {
+        return false;
+    }
+    while (c < _end && (isalnum((uchar)*c) || *c == '_')) {
+        c++;
+    }
+    *name = _current;
+    *length = c - _current;
+    _current = c;
+    _skipSpaces();
+    return true;
+}
+
+bool TilesetParser::_integer (int *value)
+{
+    const char *c = _current;
+    bool negative = c < _end && *c == '-';
+    if (negative) {
+        c++;
+    }
+    const char *digits = c;
+    int v = 0;
+    while (c < _end && *c >= '0' && *c <= '9' && c - digits < 9) {
+        v = v * 10 + (*c - '0');
+        c++;
+    }
+    if (c == digits || (c < _end && (isalnum((uchar)*c) || *c == '.'))) {
+        return false;
+    }
+    *value = negative ? -v : v;
+    _current = c;
+    _skipSpaces();
+    return true;
+}
+
+bool TilesetParser::_string (const char **string, int *length)
+{
+    char quote = *_current;
+    const char *c = _current + 1;
+    while (c < _end && *c != quote) {
+        if (*c == '\\' || *c == '\n') {
+            return false;
+        }
+        c++;
+    }
+    if (c >= _end) {
+        return false;
+    }
+    *string = _current + 1;
+    *length = c - _current - 1;
+    _current = c + 1;
+    _skipSpaces();
+    return true;
+}
+
+bool TilesetParser::_symbol (char symbol)
+{
+    if (_current < _end && *_current == symbol) {
+        _current++;
+        _skipSpaces();
+        return true;
+    }
+    return false;
+}
+
+void TilesetParser::_skipSpaces ()
+{
+    while (_current < _end) {
+        if (isspace((uchar)*_current)) {
+            _current++;
+        } else if (
+            _current + 1 < _end && _current[0] == '-' && _current[1] == '-'
+        ) {
+            if (
+                _current + 3 < _end && _current[2] == '[' &&
+                (_current[3] == '[' || _current[3] == '=')
+            ) {
+                _unsupported = true;
+                _current = _end;
+                return;
+            }
+            while (_current < _end && *_current != '\n') {
+                _current++;
+            }
+        } else {
+            return;
+        }
+    }
+}
+
+int TilesetParser::_lookup (
+    const char **names, int n, const char *name, int length
+) {
+    for (int i = 0; i < n; ++i) {
+        if (qstrlen(names[i]) == (uint)length &&
+            qstrncmp(names[i], name, length) == 0
+        ) {
+            return i;
+        }
+    }
+    return -1;
+}
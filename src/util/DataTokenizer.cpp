@@ -0,0 +1,117 @@
+/*
+ * Solarus Quest Creator - GUI to build games for Solarus engine
+ * Copyright (C) 2013, Van den Branden Maxime <max.van.den.branden@gmail.com>
+ *
+ * Licensed under the EUPL, Version 1.1
+ * You may not use this work except in compliance with the Licence.
+ * You may obtain a copy of the Licence at:
+ *
+ * http://ec.europa.eu/idabc/eupl
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the Licence is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the Licence for the specific language governing permissions and
+ * limitations under the Licence.
+ */
+#include "util/DataTokenizer.h"
+
+DataTokenizer::DataTokenizer (const char *data, qint64 size) :
+    _current(data),
+    _end(data + size),
+    _line(1)
+{}
+
+bool DataTokenizer::atEnd () const
+{
+    return _current >= _end;
+}
+
+int DataTokenizer::line () const
+{
+    return _line;
+}
+
+void DataTokenizer::skipBlankLines ()
+{
+    const char *c = _current;
+    while (c < _end) {
+        if (*c == '\n') {
+            _current = c + 1;
+            _line++;
+        } else if (*c != ' ' && *c != '\t' && *c != '\r') {
+            return;
+        }
+        c++;
+    }
+    _current = _end;
+}
+
+bool DataTokenizer::word (QString *word)
+{
+    const char *start = _current;
+    while (
+        _current < _end && *_current != ' ' && *_current != '\t' &&
+        *_current != '\r' && *_current != '\n'
+    ) {
+        _current++;
+    }
+    if (_current == start) {
+        return false;
+    }
+    *word = QString::fromLocal8Bit(start, _current - start);
+    return true;
+}
+
+bool DataTokenizer::integer (int *value)
+{
+    const char *c = _current;
+    bool negative = false;
+    if (c < _end && (*c == '-' || *c == '+')) {
+        negative = *c == '-';
+        c++;
+    }
+    const char *digits = c;
+    int v = 0;
+    while (c < _end && *c >= '0' && *c <= '9') {
+        if (c - digits == 9) {
+            return false;
+        }
+        v = v * 10 + (*c - '0');
+        c++;
+    }
+    if (c == digits) {
+        return false;
+    }
+    _current = c;
+    *value = negative ? -v : v;
+    return true;
+}
+
+bool DataTokenizer::separator (char separator)
+{
+    if (_current < _end && *_current == separator) {
+        _current++;
+        return true;
+    }
+    return false;
+}
+
+bool DataTokenizer::endOfLine ()
+{
+    if (_current < _end && *_current == '\r') {
+        if (_current + 1 < _end && _current[1] != '\n') {
+            return false;
+        }
+        _current++;
+    }
+    if (_current >= _end) {
+        return true;
+    }
+    if (*_current != '\n') {
+        return false;
+    }
+    _current++;
+    _line++;
+    return true;
+}
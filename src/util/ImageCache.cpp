@@ -0,0 +1,76 @@
+/*
+ * Solarus Quest Creator - GUI to build games for Solarus engine
+ * Copyright (C) 2013, Van den Branden Maxime <max.van.den.branden@gmail.com>
+ *
+ * Licensed under the EUPL, Version 1.1
+ * You may not use this work except in compliance with the Licence.
+ * You may obtain a copy of the Licence at:
+ *
+ * http://ec.europa.eu/idabc/eupl
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the Licence is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the Licence for the specific language governing permissions and
+ * limitations under the Licence.
+ */
+#include <QFileInfo>
+#include <QDateTime>
+#include "util/ImageCache.h"
+
+QCache<QString, QPixmap> ImageCache::_cache(DEFAULT_MAX_MEMORY);
+
+QPixmap ImageCache::pixmap (QString path)
+{
+    QPixmap pix;
+    if (!find(path, &pix) && pix.load(path)) {
+        _cache.insert(_key(path), new QPixmap(pix), _cost(pix));
+    }
+    return pix;
+}
+
+bool ImageCache::find (QString path, QPixmap *pix)
+{
+    QPixmap *cached = _cache.object(_key(path));
+    if (cached == 0) {
+        return false;
+    }
+    *pix = *cached;
+    return true;
+}
+
+QPixmap ImageCache::insert (QString path, const QImage &image)
+{
+    QPixmap pix = QPixmap::fromImage(image);
+    if (!pix.isNull()) {
+        _cache.insert(_key(path), new QPixmap(pix), _cost(pix));
+    }
+    return pix;
+}
+
+int ImageCache::maxMemory ()
+{
+    return _cache.maxCost();
+}
+
+void ImageCache::setMaxMemory (int bytes)
+{
+    _cache.setMaxCost(bytes);
+}
+
+void ImageCache::clear ()
+{
+    _cache.clear();
+}
+
+QString ImageCache::_key (QString path)
+{
+    QFileInfo info(path);
+    return info.absoluteFilePath() + "@" +
+        QString::number(info.lastModified().toMSecsSinceEpoch());
+}
+
+int ImageCache::_cost (const QPixmap &pix)
+{
+    return pix.width() * pix.height() * qMax(pix.depth() / 8, 1);
+}
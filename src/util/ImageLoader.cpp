@@ -0,0 +1,92 @@
+/*
+ * Solarus Quest Creator - GUI to build games for Solarus engine
+ * Copyright (C) 2013, Van den Branden Maxime <max.van.den.branden@gmail.com>
+ *
+ * Licensed under the EUPL, Version 1.1
+ * You may not use this work except in compliance with the Licence.
+ * You may obtain a copy of the Licence at:
+ *
+ * http://ec.europa.eu/idabc/eupl
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the Licence is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the Licence for the specific language governing permissions and
+ * limitations under the Licence.
+ */
+#include <QThreadPool>
+#include <QImageReader>
+#include "util/ImageLoader.h"
+#include "util/ImageCache.h"
+
+ImageLoader::ImageLoader (QObject *parent) :
+    QObject(parent),
+    _generation(new QAtomicInt(0)),
+    _loading(false)
+{}
+
+void ImageLoader::load (QString path)
+{
+    int generation = _generation->fetchAndAddOrdered(1) + 1;
+    _loading = true;
+    _path = path;
+    ImageDecodeTask *task = new ImageDecodeTask(path, generation, _generation);
+    task->setAutoDelete(false);
+    connect(
+        task, SIGNAL(decoded(int,QString,QImage)),
+        this, SLOT(_decoded(int,QString,QImage)), Qt::QueuedConnection
+    );
+    connect(
+        task, SIGNAL(decoded(int,QString,QImage)),
+        task, SLOT(deleteLater())
+    );
+    QThreadPool::globalInstance()->start(task);
+}
+
+void ImageLoader::cancel ()
+{
+    _generation->fetchAndAddOrdered(1);
+    _loading = false;
+    _path = "";
+}
+
+bool ImageLoader::isLoading () const
+{
+    return _loading;
+}
+
+QString ImageLoader::path () const
+{
+    return _path;
+}
+
+void ImageLoader::_decoded (int generation, QString path, QImage image)
+{
+    if (generation != _generation->load()) {
+        return;
+    }
+    _loading = false;
+    QPixmap pix;
+    if (!image.isNull()) {
+        pix = ImageCache::insert(path, image);
+    }
+    emit loaded(path, pix);
+}
+
+ImageDecodeTask::ImageDecodeTask (
+    QString path, int generation, QSharedPointer<QAtomicInt> current
+) :
+    _path(path),
+    _generation(generation),
+    _current(current)
+{}
+
+void ImageDecodeTask::run ()
+{
+    QImage image;
+    if (_generation == _current->load()) {
+        QImageReader reader(_path);
+        image = reader.read();
+    }
+    emit decoded(_generation, _path, image);
+}
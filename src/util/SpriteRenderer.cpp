@@ -0,0 +1,174 @@
+/*
+ * Solarus Quest Creator - GUI to build games for Solarus engine
+ * Copyright (C) 2013, Van den Branden Maxime <max.van.den.branden@gmail.com>
+ *
+ * Licensed under the EUPL, Version 1.1
+ * You may not use this work except in compliance with the Licence.
+ * You may obtain a copy of the Licence at:
+ *
+ * http://ec.europa.eu/idabc/eupl
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the Licence is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the Licence for the specific language governing permissions and
+ * limitations under the Licence.
+ */
+#include <QPainter>
+#include <QThreadPool>
+#include <QMutexLocker>
+#include "util/SpriteRenderer.h"
+#include "sol/Quest.h"
+#include "sol/Sprite.h"
+
+SpriteRenderer::SpriteRenderer (QString dataDirectory, QString tileset) :
+    _dataDirectory(dataDirectory),
+    _tileset(tileset)
+{}
+
+QString SpriteRenderer::imagePath (const SpriteAnimation &animation) const
+{
+    if (animation.image() == "tileset") {
+        return _dataDirectory + "tilesets/" + _tileset + ".entities.png";
+    }
+    return _dataDirectory + "sprites/" + animation.image();
+}
+
+QImage SpriteRenderer::frame (
+    const SpriteAnimation &animation, int direction, int frame,
+    QColor background
+) throw(SQCException) {
+    SpriteDirection dir = animation.direction(direction);
+    QList<Rect> frames = dir.frames();
+    if (frame < 0 || frame >= frames.size()) {
+        QString message = QObject::tr("frame '$1' does not exists");
+        message.replace("$1", QString::number(frame));
+        throw SQCException(message);
+    }
+    Rect rect = frames[frame];
+    QImage image(rect.width, rect.height, QImage::Format_ARGB32_Premultiplied);
+    image.fill(background);
+    QImage sheet = _image(imagePath(animation));
+    if (!sheet.isNull()) {
+        QPainter painter(&image);
+        painter.drawImage(
+            0, 0, sheet, rect.x, rect.y, rect.width, rect.height
+        );
+    }
+    return image;
+}
+
+QImage SpriteRenderer::frame (
+    const Sprite &sprite, QString animation, int direction, int frame
+) throw(SQCException) {
+    return this->frame(sprite.animation(animation), direction, frame);
+}
+
+QImage SpriteRenderer::thumbnail (
+    const SpriteAnimation &animation, const QSize &size
+) {
+    if (
+        animation.countDirections() == 0 ||
+        _image(imagePath(animation)).isNull()
+    ) {
+        return QImage();
+    }
+    QImage first;
+    try {
+        first = frame(animation, 0, 0);
+    } catch (const SQCException &ex) {
+        return QImage();
+    }
+    return fit(first, size);
+}
+
+QMap<QString, QImage> SpriteRenderer::thumbnails (
+    const Sprite &sprite, const QSize &size
+) {
+    QMap<QString, QImage> thumbnails;
+    QList<SpriteAnimation> animations = sprite.allAnimations();
+    for (int i = 0; i < animations.size(); i++) {
+        QImage image = thumbnail(animations[i], size);
+        if (!image.isNull()) {
+            thumbnails[animations[i].name()] = image;
+        }
+    }
+    return thumbnails;
+}
+
+SpriteRenderer::Thumbnails SpriteRenderer::questThumbnails (
+    const Quest *quest, QString tileset, const QSize &size, int maxThreads
+) {
+    SpriteRenderer renderer(quest->dataDirectory(), tileset);
+    Thumbnails result;
+    QMutex mutex;
+    QThreadPool pool;
+    if (maxThreads > 0) {
+        pool.setMaxThreadCount(maxThreads);
+    }
+    QMap<QString, QString> sprites = quest->resourceNames(SPRITE);
+    QMap<QString, QString>::Iterator it = sprites.begin();
+    for (; it != sprites.end(); ++it) {
+        pool.start(
+            new Task(&renderer, it.key(), it.value(), size, &result, &mutex)
+        );
+    }
+    pool.waitForDone();
+    return result;
+}
+
+QImage SpriteRenderer::fit (const QImage &image, const QSize &size)
+{
+    QImage result(size, QImage::Format_ARGB32_Premultiplied);
+    result.fill(Qt::transparent);
+    bool reduce = image.width() > size.width() ||
+        image.height() > size.height();
+    QImage scaled = image.scaled(
+        size, Qt::KeepAspectRatio,
+        reduce ? Qt::SmoothTransformation : Qt::FastTransformation
+    );
+    QPainter painter(&result);
+    painter.drawImage(
+        (size.width() - scaled.width()) / 2,
+        (size.height() - scaled.height()) / 2, scaled
+    );
+    return result;
+}
+
+SpriteRenderer::Task::Task (
+    SpriteRenderer *renderer, QString id, QString name, QSize size,
+    Thumbnails *result, QMutex *mutex
+) :
+    _renderer(renderer),
+    _id(id),
+    _name(name),
+    _size(size),
+    _result(result),
+    _mutex(mutex)
+{}
+
+void SpriteRenderer::Task::run ()
+{
+    Sprite *sprite = 0;
+    try {
+        sprite = Sprite::load(_renderer->_dataDirectory, _id, _name);
+    } catch (...) {
+        return;
+    }
+    QMap<QString, QImage> thumbnails = _renderer->thumbnails(*sprite, _size);
+    delete sprite;
+    QMutexLocker locker(_mutex);
+    (*_result)[_id] = thumbnails;
+}
+
+QImage SpriteRenderer::_image (QString path)
+{
+    QMutexLocker locker(&_mutex);
+    if (!_images.contains(path)) {
+        locker.unlock();
+        QImage image(path);
+        locker.relock();
+        _images[path] = image;
+    }
+    return _images[path];
+}